@@ -0,0 +1,30 @@
+# Copyright (C) 2023 Freie Universität Berlin
+#
+# SPDX-License-Identifier: GPL-3.0-only
+
+"""pyperf-based microbenchmarks for pylibschc.
+
+Run the whole suite with ``tox -e benchmark`` (or ``python -m benchmarks``); each
+sub-suite writes a pyperf JSON file that can be compared between releases with
+``pyperf compare_to``. Individual sub-suites can be run directly, e.g.
+``python -m benchmarks.bench_compressor -o compressor.json``.
+"""
+
+import os
+import sys
+
+__author__ = "Martine S. Lenders"
+__copyright__ = "Copyright 2023 Freie Universität Berlin"
+__license__ = "GPLv3"
+__email__ = "m.lenders@fu-berlin.de"
+
+# the benchmarks are run as ``python -m benchmarks`` from the repository root, which
+# puts the repository root on sys.path; drop it again so ``import pylibschc`` finds
+# the installed package with its compiled extension instead of the source tree
+_repo_root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path[:] = [
+    path
+    for path in sys.path
+    if os.path.abspath(path if path else os.getcwd()) != _repo_root
+]
+del _repo_root
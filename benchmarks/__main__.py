@@ -0,0 +1,44 @@
+# Copyright (C) 2023 Freie Universität Berlin
+#
+# SPDX-License-Identifier: GPL-3.0-only
+
+"""Run all benchmark sub-suites, writing one pyperf JSON file each."""
+
+import argparse
+import os
+import subprocess
+import sys
+
+__author__ = "Martine S. Lenders"
+__copyright__ = "Copyright 2023 Freie Universität Berlin"
+__license__ = "GPLv3"
+__email__ = "m.lenders@fu-berlin.de"
+
+SUITES = ("bench_bitarray", "bench_compressor", "bench_fragmenter")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument(
+        "-o",
+        "--output-dir",
+        default="benchmark-results",
+        help="Directory the pyperf JSON files are written to "
+        "(default: %(default)s). Compare two result sets with "
+        "``pyperf compare_to``.",
+    )
+    args, pyperf_args = parser.parse_known_args()
+    os.makedirs(args.output_dir, exist_ok=True)
+    for suite in SUITES:
+        output = os.path.join(args.output_dir, f"{suite}.json")
+        if os.path.exists(output):
+            os.unlink(output)  # pyperf refuses to overwrite existing output
+        subprocess.run(
+            [sys.executable, "-m", f"benchmarks.{suite}", "-o", output]
+            + pyperf_args,
+            check=True,
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,100 @@
+# Copyright (C) 2023 Freie Universität Berlin
+#
+# SPDX-License-Identifier: GPL-3.0-only
+
+"""Shared workload for the benchmarks: rule configurations and a matching packet."""
+
+import copy
+import json
+import os
+
+from scapy.all import IPv6, UDP, raw  # pylint: disable=no-name-in-module
+from scapy.contrib.coap import CoAP
+
+import pylibschc.device
+import pylibschc.rules
+
+__author__ = "Martine S. Lenders"
+__copyright__ = "Copyright 2023 Freie Universität Berlin"
+__license__ = "GPLv3"
+__email__ = "m.lenders@fu-berlin.de"
+
+RULES_EXAMPLE = os.path.join(
+    os.path.dirname(os.path.dirname(os.path.abspath(__file__))),
+    "tests",
+    "artifacts",
+    "rules_example.json",
+)
+
+
+def packet() -> bytes:
+    """A CoAP over IPv6 packet that matches a compression rule of the example
+    configuration in the UP direction."""
+    return raw(
+        IPv6(hlim=64, src="2001:db8::1", dst="2001:db8:1::2")
+        / UDP(
+            sport=5683,
+            dport=61618,
+        )
+        / CoAP(
+            ver=1,
+            code="2.05 Content",
+            type="NON",
+            msg_id=0x23B3,
+            token=b"\x32\x3a\xf3\xa3",
+            paymark=b"\xff",
+        )
+        / (
+            b'[{"id":1, "name":"CJ.H.L.(Joe) Lecomte) Heliport",'
+            b'"code":"YOY","country":"CA"}]'
+        )
+    )
+
+
+def build_config(mtu: int = None, duty_cycle: int = None) -> pylibschc.rules.Config:
+    """Build a single-device rule configuration from ``rules_example.json``.
+
+    An ``ACK_ALWAYS`` fragmentation rule is added so every
+    :class:`pylibschc.libschc.FragmentationMode` is covered.
+
+    :param mtu: (optional) Override for the MTU of the device.
+    :param duty_cycle: (optional) Override for the duty cycle of the device in
+        milliseconds.
+    """
+    with open(RULES_EXAMPLE, encoding="utf-8") as rules_file:
+        device = json.load(rules_file)["devices"][0]
+    if mtu is not None:
+        device["mtu"] = mtu
+    if duty_cycle is not None:
+        device["duty_cycle"] = duty_cycle
+    ack_always = copy.deepcopy(device["fragmentation_rules"][-1])
+    ack_always["mode"] = "ACK_ALWAYS"
+    ack_always["rule_id"] = (
+        max(rule["rule_id"] for rule in device["fragmentation_rules"]) + 1
+    )
+    device["fragmentation_rules"].append(ack_always)
+    return pylibschc.rules.Config(devices=[device])
+
+
+def deploy_devices(num_devices: int) -> pylibschc.device.Device:
+    """Deploy the example rules onto ``num_devices`` devices.
+
+    The first device is deployed from the compiled configuration; the remaining
+    devices get the same compression rules via the packed binary fast path, so
+    populating a large registry does not drown the benchmark setup in per-rule
+    model validation.
+
+    :param num_devices: The number of devices to deploy.
+    :return: The first of the deployed devices.
+    """
+    config = build_config().compile().deploy()
+    device = config.devices[0]
+    rules_binary = device.dump_rules_binary()
+    for device_id in range(2, num_devices + 1):
+        extra_device = pylibschc.device.Device(
+            device_id=device_id,
+            mtu=device.mtu,
+            duty_cycle_ms=device.duty_cycle_ms,
+        )
+        extra_device.load_rules_binary(rules_binary)
+    return device
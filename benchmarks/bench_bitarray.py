@@ -0,0 +1,47 @@
+# Copyright (C) 2023 Freie Universität Berlin
+#
+# SPDX-License-Identifier: GPL-3.0-only
+
+"""Benchmarks for :class:`pylibschc.libschc.BitArray` construction and reuse."""
+
+import pyperf
+
+# pylint: disable=import-error,no-name-in-module
+from pylibschc.libschc import BitArray
+
+__author__ = "Martine S. Lenders"
+__copyright__ = "Copyright 2023 Freie Universität Berlin"
+__license__ = "GPLv3"
+__email__ = "m.lenders@fu-berlin.de"
+
+SIZES = (32, 128, 1280)
+
+
+def bench_new(loops: int, data: bytes) -> float:
+    range_it = range(loops)
+    t_0 = pyperf.perf_counter()
+    for _ in range_it:
+        BitArray(data)
+    return pyperf.perf_counter() - t_0
+
+
+def bench_reuse(loops: int, data: bytes) -> float:
+    bit_arr = BitArray(len(data))
+    range_it = range(loops)
+    t_0 = pyperf.perf_counter()
+    for _ in range_it:
+        bit_arr.clear()
+        bit_arr.load(data)
+    return pyperf.perf_counter() - t_0
+
+
+def main():
+    runner = pyperf.Runner()
+    for size in SIZES:
+        data = bytes(size)
+        runner.bench_time_func(f"bitarray/new/{size}B", bench_new, data)
+        runner.bench_time_func(f"bitarray/reuse/{size}B", bench_reuse, data)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,67 @@
+# Copyright (C) 2023 Freie Universität Berlin
+#
+# SPDX-License-Identifier: GPL-3.0-only
+
+"""Benchmarks for :class:`pylibschc.compressor.CompressorDecompressor`.
+
+``compress`` and ``decompress`` are measured with 1, 100 and 10000 devices
+deployed, so regressions that scale with the size of the device registry show up
+next to the per-packet cost.
+"""
+
+import pyperf
+
+import pylibschc.compressor
+import pylibschc.rules
+
+try:
+    from ._workload import deploy_devices, packet
+except ImportError:  # pyperf workers re-run this module as a plain script
+    from _workload import deploy_devices, packet
+
+__author__ = "Martine S. Lenders"
+__copyright__ = "Copyright 2023 Freie Universität Berlin"
+__license__ = "GPLv3"
+__email__ = "m.lenders@fu-berlin.de"
+
+DEVICE_COUNTS = (1, 100, 10000)
+
+
+def bench_compress(loops: int, comp_dec, data: bytes) -> float:
+    direction = pylibschc.rules.Direction.UP
+    range_it = range(loops)
+    t_0 = pyperf.perf_counter()
+    for _ in range_it:
+        comp_dec.output(data, direction)
+    return pyperf.perf_counter() - t_0
+
+
+def bench_decompress(loops: int, comp_dec, compressed) -> float:
+    direction = pylibschc.rules.Direction.UP
+    range_it = range(loops)
+    t_0 = pyperf.perf_counter()
+    for _ in range_it:
+        comp_dec.input(compressed, direction)
+    return pyperf.perf_counter() - t_0
+
+
+def main():
+    runner = pyperf.Runner()
+    data = packet()
+    for num_devices in DEVICE_COUNTS:
+        device = deploy_devices(num_devices)
+        comp_dec = pylibschc.compressor.CompressorDecompressor(device=device)
+        _, compressed = comp_dec.output(data, pylibschc.rules.Direction.UP)
+        runner.bench_time_func(
+            f"compress/{num_devices}-devices", bench_compress, comp_dec, data
+        )
+        runner.bench_time_func(
+            f"decompress/{num_devices}-devices",
+            bench_decompress,
+            comp_dec,
+            compressed,
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,105 @@
+# Copyright (C) 2023 Freie Universität Berlin
+#
+# SPDX-License-Identifier: GPL-3.0-only
+
+"""Benchmarks for fragmentation and reassembly.
+
+One complete transfer — fragmentation, loopback delivery, reassembly and, for the
+ACK modes, the returned ACKs — is measured per loop for each
+:class:`pylibschc.libschc.FragmentationMode`. Fragments and ACKs are exchanged
+through a queue-driven loopback, mirroring how a receiver thread would feed
+:meth:`pylibschc.fragmenter.FragmenterReassembler.input`.
+"""
+
+import queue
+import threading
+
+import pyperf
+
+import pylibschc.device
+import pylibschc.fragmenter
+
+try:
+    from ._workload import build_config
+except ImportError:  # pyperf workers re-run this module as a plain script
+    from _workload import build_config
+
+__author__ = "Martine S. Lenders"
+__copyright__ = "Copyright 2023 Freie Universität Berlin"
+__license__ = "GPLv3"
+__email__ = "m.lenders@fu-berlin.de"
+
+# large enough to be fragmented at MTU 60, small enough for a NO_ACK window
+PAYLOAD = b"Lorem ipsum dolor sit amet, consetetur sadipscing elitr, sed diam"
+MTU = 60
+DUTY_CYCLE_MS = 1
+
+
+class Loopback:
+    """Connects a fragmenter and a reassembler on two devices of the example
+    configuration and drives reassembly in a separate thread."""
+
+    def __init__(self, mode: pylibschc.fragmenter.FragmentationMode):
+        config = build_config(mtu=MTU, duty_cycle=DUTY_CYCLE_MS).compile().deploy()
+        device_f = config.devices[0]
+        device_r = pylibschc.device.Device(
+            device_id=device_f.device_id + 1,
+            mtu=MTU,
+            duty_cycle_ms=DUTY_CYCLE_MS,
+        )
+        device_r.fragmentation_rules = device_f.fragmentation_rules
+        self.rx_done = threading.Event()
+        self._frag_queue = queue.Queue()
+        self.fragmenter = pylibschc.fragmenter.FragmenterReassembler(
+            device=device_f,
+            mode=mode,
+        )
+        self.reassembler = pylibschc.fragmenter.FragmenterReassembler(
+            device=device_r,
+            end_rx=lambda conn: self.rx_done.set(),
+        )
+        self.fragmenter.register_send(self._send_frag)
+        self.reassembler.register_send(self._send_ack)
+        threading.Thread(target=self._reassemble, daemon=True).start()
+
+    def _send_frag(self, buffer: bytes) -> int:
+        self._frag_queue.put(buffer)
+        return len(buffer)
+
+    def _send_ack(self, buffer: bytes) -> int:
+        # called from the reassembly thread, concurrently to the paced transfer
+        self.fragmenter.input(buffer)
+        return len(buffer)
+
+    def _reassemble(self):
+        while True:
+            self.reassembler.input(self._frag_queue.get())
+
+    def transfer(self, data: bytes):
+        """Send ``data`` through the loopback and block until it was reassembled."""
+        self.rx_done.clear()
+        self.fragmenter.output_paced(data)
+        self.rx_done.wait()
+
+
+def bench_transfer(loops: int, loopback: Loopback, data: bytes) -> float:
+    range_it = range(loops)
+    t_0 = pyperf.perf_counter()
+    for _ in range_it:
+        loopback.transfer(data)
+    return pyperf.perf_counter() - t_0
+
+
+def main():
+    runner = pyperf.Runner()
+    for mode in pylibschc.fragmenter.FragmentationMode:
+        if mode == pylibschc.fragmenter.FragmentationMode.NOT_FRAGMENTED:
+            continue
+        loopback = Loopback(mode)
+        runner.bench_time_func(
+            f"fragment+reassemble/{mode.name}", bench_transfer, loopback, PAYLOAD
+        )
+
+
+if __name__ == "__main__":
+    main()
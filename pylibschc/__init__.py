@@ -5,8 +5,19 @@
 
 """Base module for pylibschc."""
 
+import os
+import sys
+
 __author__ = "Martine S. Lenders"
 __copyright__ = "Copyright 2023 Freie Universität Berlin"
 __license__ = "GPLv3"
 __email__ = "m.lenders@fu-berlin.de"
 __version__ = "0.2.0b2"
+
+if os.environ.get("PYLIBSCHC_VARIANT") == "fast":
+    # use the compile-time specialized build variant (see setup.py) for all of
+    # pylibschc; must happen before anything imports pylibschc.libschc
+    from . import libschc_fast  # pylint: disable=no-name-in-module
+
+    sys.modules[f"{__name__}.libschc"] = libschc_fast
+    libschc = libschc_fast
@@ -191,19 +191,64 @@ cdef extern from "mo.h":
     ctypedef schc_mo_op_t
 
 cdef extern from "rules.h":
+    int schc_rules_device_index_add(schc_device *device)
+    void schc_rules_device_index_remove(uint32_t device_id)
+    schc_device *schc_rules_get_device_by_id(uint32_t device_id)
     schc_compression_rule_t **schc_rules_create_compr_ctx(unsigned rule_count)
-    schc_ipv6_rule_t *schc_rules_create_ipv6_rule()
-    schc_udp_rule_t *schc_rules_create_udp_rule()
-    schc_coap_rule_t *schc_rules_create_coap_rule()
+    schc_ipv6_rule_t *schc_rules_create_ipv6_rule(schc_compression_rule_t **ctx)
+    schc_udp_rule_t *schc_rules_create_udp_rule(schc_compression_rule_t **ctx)
+    schc_coap_rule_t *schc_rules_create_coap_rule(schc_compression_rule_t **ctx)
     schc_fragmentation_rule_t **schc_rules_create_frag_ctx(unsigned rule_count)
     void schc_rules_free_compr_ctx(schc_compression_rule_t **ctx, unsigned rule_count)
     void schc_rules_free_frag_ctx(schc_fragmentation_rule_t **ctx, unsigned rule_count)
 
+cdef extern from "send_registry.h":
+    const int SCHC_SEND_MMSG_BATCH
+
+    ctypedef uint8_t (*schc_send_fn_t)(void *ctx, uint8_t *data, uint16_t length)
+
+    int schc_send_register(uint32_t device_id, schc_send_fn_t send, void *ctx)
+    void schc_send_unregister(uint32_t device_id)
+    int schc_send_register_udp(uint32_t device_id, int sockfd)
+    int schc_send_register_mmsg(uint32_t device_id, int sockfd)
+    int schc_send_flush(uint32_t device_id) nogil
+    int schc_send_is_registered(uint32_t device_id)
+    uint8_t schc_send_dispatch(uint8_t *data, uint16_t length, uint32_t device_id)
+
+cdef extern from "pybits.h":
+    uint32_t pybits_get(const uint8_t *src, uint32_t pos, uint8_t len) nogil
+    void pybits_overwrite(
+        uint8_t *dst, uint32_t dst_pos,
+        const uint8_t *src, uint32_t src_pos,
+        uint32_t len
+    ) nogil
+
+cdef extern from "pystats.h":
+    const int PYSTATS_NS_BUCKETS
+
+    ctypedef struct pystats_counters_t:
+        uint64_t compress_calls
+        uint64_t compress_ns[PYSTATS_NS_BUCKETS]
+        uint64_t decompress_calls
+        uint64_t decompress_ns[PYSTATS_NS_BUCKETS]
+        uint64_t input_calls
+        uint64_t fragments_sent
+        uint64_t fragment_bytes
+
+    uint64_t pystats_now_ns() nogil
+    void pystats_record_compress(uint64_t ns) nogil
+    void pystats_record_decompress(uint64_t ns) nogil
+    void pystats_count_input() nogil
+    void pystats_count_fragment_sent(uint16_t length) nogil
+    void pystats_snapshot(pystats_counters_t *out)
+    int pystats_enabled()
+
 cdef extern from "pylogging.h":
     const int PYLOG_BUFFER_SIZE
 
     void pylog_init(PyObject *logger)
     int pylog_debug(const char *format, ...)
+    int pylog_flush()
 
 cdef extern from "libschc/compressor.h":
     uint8_t schc_compressor_init()
@@ -213,14 +258,14 @@ cdef extern from "libschc/compressor.h":
         schc_bitarray_t *buf,
         uint32_t device_id,
         direction dir
-    )
+    ) nogil
     uint16_t schc_decompress(
         schc_bitarray_t *bit_arr,
         uint8_t *buf,
         uint32_t device_id,
         uint16_t total_length,
         direction dir
-    )
+    ) nogil
 
 cdef extern from "libschc/fragmenter.h":
     const int SCHC_FRAG_INPUT
@@ -292,14 +337,14 @@ cdef extern from "libschc/fragmenter.h":
 
     int8_t schc_fragmenter_init(schc_fragmentation_t* tx_conn);
     int8_t schc_fragment(schc_fragmentation_t *tx_conn)
-    int8_t schc_reassemble(schc_fragmentation_t *rx_conn)
+    int8_t schc_reassemble(schc_fragmentation_t *rx_conn) nogil
     void schc_reset(schc_fragmentation_t *conn)
     schc_fragmentation_t *schc_input(
         uint8_t *data,
         uint16_t len,
         schc_fragmentation_t * rx_conn,
         uint32_t device_id
-    )
+    ) nogil
 
     schc_fragmentation_rule_t *get_fragmentation_rule_by_reliability_mode(
         reliability_mode mode,
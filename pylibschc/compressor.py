@@ -6,6 +6,7 @@
 
 import typing
 
+import pylibschc.context
 import pylibschc.device
 
 __author__ = "Martine S. Lenders"
@@ -20,6 +21,8 @@ from .libschc import (
     CompressorDecompressor as InnerCompressorDecompressor,
     CompressionResult,
     Direction,
+    FragmentationConnection,
+    MAX_MTU_LENGTH,
 )
 
 
@@ -30,13 +33,6 @@ class CompressorDecompressor:
     usage."""
 
     _inner_cls = InnerCompressorDecompressor
-    _inner = None
-
-    def __new__(cls, *args, **kwargs):  # pylint: disable=unused-argument
-        if not cls._inner:
-            cls._inner = cls._inner_cls()
-            cls._inner.init()
-        return super().__new__(cls)
 
     def __init__(self, device: pylibschc.device.Device):
         """
@@ -48,18 +44,30 @@ class CompressorDecompressor:
 
            Device to be used for compression/decompression.
         """
+        self._inner = pylibschc.context.EngineContext.current().compressor_inner(
+            self._inner_cls
+        )
         self.device = device
 
     def output(
-        self, data: typing.Union[bytes, BitArray], direction: Direction
+        self,
+        data: typing.Union[bytes, bytearray, memoryview, BitArray],
+        direction: Direction,
+        bit_arr: BitArray = None,
     ) -> typing.Tuple[CompressionResult, BitArray]:
         """Compress according to the compression rules of
         :py:attr:`CompressorDecompressor.device`.
 
-        :param data: The data to compress.
+        :param data: The data to compress. Apart from a
+            :class:`pylibschc.libschc.BitArray`, any object implementing the buffer
+            protocol is accepted and read without an intermediate copy.
         :param direction: Direction to use for compression.
+        :param bit_arr: (optional) A :class:`pylibschc.libschc.BitArray` to re-use for
+            the compression result instead of allocating a new one.
         :raise TypeError: When ``data`` is not of the expected input type.
         :raise ValueError: When direction is :attr:`pylibschc.libschc.Direction.BI`.
+        :raise ValueError: When ``bit_arr`` is provided but too small for the
+            compression result.
         :return: Whether the packet was compressed or the uncompressed rule was used
             and the compressed packet as a :class:`pylibschc.libschc.BitArray`.
         :rtype: :class:`typing.Tuple` [
@@ -71,11 +79,40 @@ class CompressorDecompressor:
             raise ValueError("direction must be either UP or DOWN, not BI")
         if isinstance(data, BitArray):
             byts = data.buffer
-        elif isinstance(data, bytes):
-            byts = data
         else:
-            raise TypeError(f"data ({data}) expected to be either bytes or BitArray")
-        return self._inner.compress(byts, self.device.__inner__, direction)
+            byts = data
+        return self._inner.compress(byts, self.device.__inner__, direction, bit_arr)
+
+    def output_batch(
+        self,
+        packets: typing.Sequence[typing.Union[bytes, bytearray, memoryview]],
+        direction: Direction,
+    ) -> typing.List[typing.Tuple[CompressionResult, BitArray]]:
+        """Compress a batch of packets according to the compression rules of
+        :py:attr:`CompressorDecompressor.device`.
+
+        The batch is iterated over in C with the GIL released, amortizing per-call
+        overhead over all packets of a burst.
+
+        :param packets: The packets to compress. Each may be any object implementing
+            the buffer protocol.
+        :param direction: Direction to use for compression.
+        :raise TypeError: When a packet is not of the expected input type.
+        :raise ValueError: When direction is :attr:`pylibschc.libschc.Direction.BI`.
+        :raise ValueError: When a packet could not be compressed.
+        :return: For each packet, whether it was compressed or the uncompressed rule
+            was used and the compressed packet as a
+            :class:`pylibschc.libschc.BitArray`, in the order of ``packets``.
+        :rtype: :class:`typing.List` [ :class:`typing.Tuple` [
+            :class:`pylibschc.libschc.CompressionResult` ,
+            :class:`pylibschc.libschc.BitArray`
+            ] ]
+        """
+        if direction == Direction.BI:
+            raise ValueError("direction must be either UP or DOWN, not BI")
+        return self._inner.compress_batch(
+            packets, self.device.__inner__, direction
+        )
 
     def input(self, data: typing.Union[bytes, BitArray], direction: Direction) -> bytes:
         """Decompress according to the compression rules of
@@ -97,3 +134,62 @@ class CompressorDecompressor:
         else:
             raise TypeError(f"data ({data}) expected to be either bytes or BitArray")
         return self._inner.decompress(bit_array, self.device.__inner__, direction)
+
+    def input_mbuf(
+        self, conn: FragmentationConnection, direction: Direction
+    ) -> bytes:
+        """Decompress the reassembled packet of ``conn`` according to the compression
+        rules of :py:attr:`CompressorDecompressor.device`.
+
+        In contrast to decompressing :attr:`FragmentationConnection.mbuf` with
+        :py:meth:`CompressorDecompressor.input`, the mbuf chain of ``conn`` is handed
+        to the decompressor directly, without materializing the reassembled packet as
+        an intermediate :class:`bytes` object first. Intended for use from an
+        ``end_rx`` callback, i.e., while the reassembly buffer of ``conn`` is still
+        valid.
+
+        :param conn: The fragmentation connection holding the reassembled packet.
+        :param direction: Direction to use for decompression.
+        :raise ValueError: When direction is :attr:`pylibschc.libschc.Direction.BI`.
+        :return: The decompressed data.
+        :rtype: :class:`bytes`
+        """
+        if direction == Direction.BI:
+            raise ValueError("direction must be either UP or DOWN, not BI")
+        return conn.reassemble_and_decompress(self.device.__inner__, direction)
+
+    def input_into(
+        self,
+        data: typing.Union[bytes, BitArray],
+        direction: Direction,
+        out: typing.Union[bytearray, memoryview],
+    ) -> int:
+        """Decompress according to the compression rules of
+        :py:attr:`CompressorDecompressor.device` into a caller-provided buffer.
+
+        In contrast to :py:meth:`CompressorDecompressor.input` this performs no heap
+        allocation for the result, so ``out`` can come from a pool of reusable,
+        MTU-sized buffers.
+
+        :param data: The data to decompress.
+        :param direction: Direction to use for decompression.
+        :param out: A writable buffer the decompressed packet is written to. Must be at
+            least :attr:`pylibschc.libschc.MAX_MTU_LENGTH` bytes long.
+        :raise TypeError: When ``data`` or ``out`` is not of the expected input type.
+        :raise ValueError: When direction is :attr:`pylibschc.libschc.Direction.BI`.
+        :raise ValueError: When ``out`` is smaller than
+            :attr:`pylibschc.libschc.MAX_MTU_LENGTH` bytes.
+        :return: The length of the decompressed packet within ``out``.
+        :rtype: :class:`int`
+        """
+        if direction == Direction.BI:
+            raise ValueError("direction must be either UP or DOWN, not BI")
+        if isinstance(data, BitArray):
+            bit_array = data
+        elif isinstance(data, bytes):
+            bit_array = BitArray(data)
+        else:
+            raise TypeError(f"data ({data}) expected to be either bytes or BitArray")
+        return self._inner.decompress_into(
+            bit_array, out, self.device.__inner__, direction
+        )
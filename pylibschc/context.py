@@ -0,0 +1,79 @@
+# Copyright (C) 2023 Freie Universität Berlin
+#
+# SPDX-License-Identifier: GPL-3.0-only
+
+"""Explicit per-interpreter state of the libSCHC wrapper."""
+
+import threading
+
+__author__ = "Martine S. Lenders"
+__copyright__ = "Copyright 2023 Freie Universität Berlin"
+__license__ = "GPLv3"
+__email__ = "m.lenders@fu-berlin.de"
+
+
+class EngineContext:
+    """The module-level state of one SCHC engine, gathered into one object.
+
+    The device registry and the shared
+    :class:`pylibschc.libschc.CompressorDecompressor` historically lived in
+    class attributes of :class:`pylibschc.device.Device` and
+    :class:`pylibschc.compressor.CompressorDecompressor`. This class makes
+    that state explicit: every interpreter gets its own default context (see
+    :meth:`EngineContext.current`), so sub-interpreters do not see each
+    other's device registrations, and registry mutation is serialized with
+    :attr:`EngineContext.lock` for free-threaded (PEP 703) builds, where
+    plain dict mutation from several threads is no longer ordered by the GIL.
+
+    .. note:: The C state underneath — libSCHC's device list and connection
+       pools as well as the device index and send registry of the extension
+       module — is still process-global. Until the extension module supports
+       per-interpreter module state, sub-interpreters therefore share one C
+       engine and must use disjoint device IDs.
+
+    .. py:attribute:: devices
+       :type: typing.Dict[int, pylibschc.device.Device]
+
+       The devices registered with this engine, by device ID.
+
+    .. py:attribute:: lock
+       :type: threading.Lock
+
+       Serializes mutation of :attr:`EngineContext.devices`.
+    """
+
+    def __init__(self):
+        self.devices = {}
+        self.lock = threading.Lock()
+        self._compressor_inner = None
+
+    @classmethod
+    def current(cls) -> "EngineContext":
+        """The default engine context of this interpreter, created on first
+        use."""
+        global _current  # pylint: disable=global-statement
+        if _current is None:
+            with _current_lock:
+                if _current is None:
+                    _current = cls()
+        return _current
+
+    def compressor_inner(self, inner_cls: type):
+        """The initialized inner compressor/decompressor shared by all
+        :class:`pylibschc.compressor.CompressorDecompressor` objects of this
+        engine, created on first use.
+
+        :param inner_cls: Class of the inner compressor/decompressor, usually
+            :class:`pylibschc.libschc.CompressorDecompressor`.
+        """
+        if self._compressor_inner is None:
+            with self.lock:
+                if self._compressor_inner is None:
+                    inner = inner_cls()
+                    inner.init()
+                    self._compressor_inner = inner
+        return self._compressor_inner
+
+
+_current = None
+_current_lock = threading.Lock()
@@ -5,8 +5,10 @@
 """User-facing representation of libSCHC devices."""
 
 from __future__ import annotations
+import mmap
 import typing
 
+from pylibschc import context
 from pylibschc import libschc  # pylint: disable=import-error,no-name-in-module
 from pylibschc import rules  # pylint: disable=cyclic-import
 
@@ -25,15 +27,15 @@ class Device:  # pylint: disable=too-many-instance-attributes
 
     """
 
-    _devices = {}
-
     def __new__(cls, device_id: int, mtu: int, duty_cycle_ms: int):
         # pylint: disable=unused-argument
         if device_id <= 0:
             raise ValueError(f"device_id must be > 0 (was {device_id})")
-        if device_id not in cls._devices:
-            cls._devices[device_id] = super().__new__(cls)
-        return cls._devices[device_id]
+        ctx = context.EngineContext.current()
+        with ctx.lock:
+            if device_id not in ctx.devices:
+                ctx.devices[device_id] = super().__new__(cls)
+            return ctx.devices[device_id]
 
     def __init__(self, device_id: int, mtu: int, duty_cycle_ms: int):
         """
@@ -61,6 +63,10 @@ class Device:  # pylint: disable=too-many-instance-attributes
         self._compression_rules = None
         self._fragmentation_rules = None
         self._uncompressed_rule = None
+        # survives re-construction of the multiton so re-deploying an unchanged
+        # compiled config stays a no-op
+        if not hasattr(self, "_applied_rules_hash"):
+            self._applied_rules_hash = None
 
     @classmethod
     def delete(cls, device_id: int):
@@ -68,10 +74,11 @@ class Device:  # pylint: disable=too-many-instance-attributes
 
         :param device_id: The libSCHC-internal identifier of the device.
         :type device_id: :py:class:`int`"""
-        if device_id not in cls._devices:
-            return
-        device = cls._devices[device_id]
-        del cls._devices[device_id]
+        ctx = context.EngineContext.current()
+        with ctx.lock:
+            if device_id not in ctx.devices:
+                return
+            device = ctx.devices.pop(device_id)
         # ensure everything is cleaned up
         device._inner.unregister()  # pylint: disable=protected-access
         del device._inner
@@ -83,20 +90,21 @@ class Device:  # pylint: disable=too-many-instance-attributes
 
         :param device_id: The libSCHC-internal identifier of the device.
         :type device_id: :py:class:`int`"""
+        devices = context.EngineContext.current().devices
         try:
-            return cls._devices[device_id]
+            return devices[device_id]
         except KeyError as exc:
             # try to recover from dangling state
             try:
-                cls._devices[device_id] = libschc.Device.get(device_id)
-                return cls._devices[device_id]  # pragma: no cover
+                devices[device_id] = libschc.Device.get(device_id)
+                return devices[device_id]  # pragma: no cover
             except KeyError:
                 raise exc  # pylint: disable=raise-missing-from
 
     @classmethod
     def iter(cls) -> typing.Generator[Device]:
         """Iterates over all devices deployed in libSCHC."""
-        for _, device in sorted(cls._devices.items()):
+        for _, device in sorted(context.EngineContext.current().devices.items()):
             yield device
 
     @property
@@ -126,6 +134,119 @@ class Device:  # pylint: disable=too-many-instance-attributes
         else:
             self._inner.compression_rules = [r.dict() for r in compression_rules or []]
         self._compression_rules = None
+        self._applied_rules_hash = None
+
+    def apply_compiled_rules(
+        self,
+        compression_rules: typing.Optional[typing.List[dict]],
+        fragmentation_rules: typing.Optional[typing.List[dict]],
+        uncompressed_rule: typing.Optional[typing.Tuple[int, int]],
+        content_hash: typing.Optional[str] = None,
+    ):
+        """Apply pre-lowered rules to the libSCHC version of this device.
+
+        Used by :meth:`pylibschc.rules.CompiledConfig.deploy`: the rules are plain
+        dicts as consumed by the libSCHC wrapper, so no pydantic validation runs.
+        When ``content_hash`` equals the hash of the compiled config already applied
+        to this device, the call returns without touching the rule contexts.
+
+        :param compression_rules: The lowered compression rules, or None to clear
+            the compression context.
+        :param fragmentation_rules: The lowered fragmentation rules, or None to
+            clear the fragmentation context.
+        :param uncompressed_rule: ``(rule_id, rule_id_size_bits)`` of the rule for
+            uncompressed packets, or None.
+        :param content_hash: Identifies the compiled config these rules come from.
+        """
+        if content_hash is not None and content_hash == self._applied_rules_hash:
+            return
+        if compression_rules is None:
+            del self._inner.compression_rules
+        else:
+            self._inner.compression_rules = compression_rules
+        if fragmentation_rules is None:
+            del self._inner.fragmentation_rules
+        else:
+            self._inner.fragmentation_rules = fragmentation_rules
+        if uncompressed_rule:
+            self._inner.uncompressed_rule_id = uncompressed_rule[0]
+            self._inner.uncompressed_rule_id_size_bits = uncompressed_rule[1]
+        else:
+            self._inner.uncompressed_rule_id = 0
+            self._inner.uncompressed_rule_id_size_bits = 0
+        self._compression_rules = None
+        self._fragmentation_rules = None
+        self._uncompressed_rule = None
+        self._applied_rules_hash = content_hash
+
+    @property
+    def promote_matched_rules(self) -> bool:
+        """Whether a matched compression rule is moved to the front of the context.
+
+        When True, a rule matched during compression is promoted to the front of the
+        compression context of the libSCHC version of this device, so flow-skewed
+        traffic matches its hot rule on the first try instead of scanning the whole
+        context (default: False). Note that this reorders the internal compression
+        context in place; when several rules match a packet, the promoted rule is
+        picked over earlier-listed ones.
+        """
+        return self._inner.promote_matched_rules
+
+    @promote_matched_rules.setter
+    def promote_matched_rules(self, promote_matched_rules: bool):
+        self._inner.promote_matched_rules = promote_matched_rules
+
+    def load_rules_binary(self, buf: bytes):
+        """Load the compression rules of this device from their packed binary form.
+
+        In contrast to setting :attr:`Device.compression_rules`, this skips any
+        per-rule model traversal and copies the field descriptors straight into the
+        compression context of the libSCHC version of this device. See
+        :meth:`pylibschc.libschc.Device.load_rules_binary` for the format.
+
+        :param buf: The packed binary compression context, as produced by
+            :meth:`Device.dump_rules_binary`.
+        :type buf: :py:class:`bytes`"""
+        self._inner.load_rules_binary(buf)
+        self._compression_rules = None
+        self._applied_rules_hash = None
+
+    def dump_rules_binary(self) -> bytes:
+        """Serialize the compression rules of this device to their packed binary form.
+
+        :return: The packed binary compression context for use with
+            :meth:`Device.load_rules_binary`.
+        :rtype: :py:class:`bytes`"""
+        return self._inner.dump_rules_binary()
+
+    def load_rules_file(self, path: str):
+        """Load the compression rules of this device from a packed binary rule file.
+
+        The file is memory-mapped read-only and parsed in place, so loading does not
+        copy the file into an intermediate :py:class:`bytes` object and a cold start
+        is served straight from the page cache. Multiple processes loading the same
+        rule file share a single physical copy of the packed context.
+
+        :param path: Path to a file containing the packed binary compression context,
+            as written by :meth:`Device.dump_rules_file`.
+        :type path: :py:class:`str`"""
+        with open(path, "rb") as rules_file:
+            with mmap.mmap(
+                rules_file.fileno(), 0, access=mmap.ACCESS_READ
+            ) as rules_map:
+                with memoryview(rules_map) as view:
+                    self._inner.load_rules_binary(view)
+        self._compression_rules = None
+        self._applied_rules_hash = None
+
+    def dump_rules_file(self, path: str):
+        """Write the compression rules of this device to a packed binary rule file.
+
+        :param path: Path to write the packed binary compression context to, for use
+            with :meth:`Device.load_rules_file`.
+        :type path: :py:class:`str`"""
+        with open(path, "wb") as rules_file:
+            rules_file.write(self._inner.dump_rules_binary())
 
     @property
     def device_id(self) -> int:
@@ -160,6 +281,7 @@ class Device:  # pylint: disable=too-many-instance-attributes
         else:
             self._inner.fragmentation_rules = [r.dict() for r in fragmentation_rules]
         self._fragmentation_rules = None
+        self._applied_rules_hash = None
 
     @property
     def uncompressed_rule(self) -> rules.UncompressedRule:
@@ -191,3 +313,4 @@ class Device:  # pylint: disable=too-many-instance-attributes
             self._inner.uncompressed_rule_id = 0
             self._inner.uncompressed_rule_id_size_bits = 0
         self._uncompressed_rule = None
+        self._applied_rules_hash = None
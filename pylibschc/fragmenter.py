@@ -4,7 +4,12 @@
 
 """User-facing fragmenter/reassembler functionality"""
 
+import asyncio
+import logging
+import mmap
+import socket
 import threading
+import time
 import typing
 
 import pylibschc.device
@@ -18,6 +23,8 @@ __email__ = "m.lenders@fu-berlin.de"
 # pylint: disable=import-error
 from .libschc import (
     BitArray,
+    CompressionResult,
+    Direction,
     FragmenterOps,
     FragmentationConnection,
     FragmentationMode,
@@ -28,6 +35,127 @@ from .libschc import (
 )
 
 
+logger = logging.getLogger(__name__)
+
+
+class _TimerEntry:  # pylint: disable=too-few-public-methods
+    __slots__ = ("conn", "timer_task", "arg", "rounds", "cancelled")
+
+    def __init__(self, conn, timer_task, arg, rounds):
+        self.conn = conn
+        self.timer_task = timer_task
+        self.arg = arg
+        self.rounds = rounds
+        self.cancelled = False
+
+
+class TimerWheel:
+    """A hashed timer wheel driven by a single worker thread.
+
+    Scheduling and canceling a timer are both O(1) and an armed timer is a plain
+    Python object, so tens of thousands of concurrently armed fragmentation timers
+    cost a few MB instead of one thread-backed :class:`threading.Timer` each.
+
+    Timer tasks run on the worker thread of the wheel, one after another. The worker
+    thread is a daemon thread that is started on the first scheduled timer.
+    """
+
+    def __init__(self, tick: float = 0.01, slots: int = 256):
+        """
+        :param tick: (optional) The tick interval of the wheel in seconds. Timer tasks
+            fire at most one tick later than scheduled.
+        :param slots: (optional) The number of slots of the wheel.
+        """
+        self._tick = tick
+        self._slots = slots
+        self._wheel = [[] for _ in range(slots)]
+        self._entries = {}
+        self._pos = 0
+        self._lock = threading.Lock()
+        self._worker = None
+
+    def _ensure_worker(self):
+        if self._worker is None:
+            self._worker = threading.Thread(
+                target=self._run, name=f"{type(self).__name__}-worker", daemon=True
+            )
+            self._worker.start()
+
+    def post_timer_task(
+        self,
+        conn: FragmentationConnection,
+        timer_task: typing.Callable[[object], None],
+        delay_sec: float,
+        arg: object,
+    ):
+        """Schedule ``timer_task(arg)`` for ``conn`` after ``delay_sec`` seconds.
+
+        A timer previously scheduled for ``conn`` is canceled. May be used as
+        ``post_timer_task`` of :class:`pylibschc.libschc.FragmenterOps`.
+        """
+        ticks = max(1, round(delay_sec / self._tick))
+        with self._lock:
+            self._ensure_worker()
+            old_entry = self._entries.pop(conn, None)
+            if old_entry is not None:
+                old_entry.cancelled = True
+            # a delay of exactly `slots` ticks lands on the current slot, which
+            # is next visited after one full revolution, so that revolution
+            # must not be counted as a round
+            entry = _TimerEntry(conn, timer_task, arg, (ticks - 1) // self._slots)
+            self._wheel[(self._pos + ticks) % self._slots].append(entry)
+            self._entries[conn] = entry
+
+    def remove_timer_entry(self, conn: FragmentationConnection):
+        """Cancel the timer scheduled for ``conn``, if there is one.
+
+        May be used as ``remove_timer_entry`` of
+        :class:`pylibschc.libschc.FragmenterOps`.
+        """
+        with self._lock:
+            entry = self._entries.pop(conn, None)
+            if entry is not None:
+                entry.cancelled = True
+
+    def _run(self):
+        while True:
+            time.sleep(self._tick)
+            expired = []
+            with self._lock:
+                self._pos = (self._pos + 1) % self._slots
+                remaining = []
+                for entry in self._wheel[self._pos]:
+                    if entry.cancelled:
+                        continue
+                    if entry.rounds > 0:
+                        entry.rounds -= 1
+                        remaining.append(entry)
+                        continue
+                    if self._entries.get(entry.conn) is entry:
+                        del self._entries[entry.conn]
+                    expired.append(entry)
+                self._wheel[self._pos] = remaining
+            for entry in expired:
+                try:
+                    entry.timer_task(entry.arg)
+                except Exception:  # pylint: disable=broad-except
+                    logger.exception("Error in timer task for %s", entry.conn)
+
+
+_default_timer_wheel = None
+_default_timer_wheel_lock = threading.Lock()
+
+
+def default_timer_wheel() -> TimerWheel:
+    """The :class:`TimerWheel` shared by all :class:`FragmenterReassembler` objects
+    that were constructed without explicit timer callbacks. Created on first use."""
+    global _default_timer_wheel  # pylint: disable=global-statement
+    with _default_timer_wheel_lock:
+        if _default_timer_wheel is None:
+            _default_timer_wheel = TimerWheel()
+        return _default_timer_wheel
+
+
 class FragmenterReassembler(FragmenterOps):
     """A handler for fragmentation and reassembly.
 
@@ -58,7 +186,9 @@ class FragmenterReassembler(FragmenterOps):
         :param end_tx: (optional) Callback that is called when the transmission of a
             packet is complete.
         :param post_timer_task: (optional) Callback that is called when a timer task
-            needs to be scheduled.
+            needs to be scheduled. When neither ``post_timer_task`` nor
+            ``remove_timer_entry`` is provided, the timers are driven by the
+            :func:`default_timer_wheel`.
         :param remove_timer_entry: (optional) Callback that is called when a timer task
             needs to be canceled. May be None.
 
@@ -94,13 +224,17 @@ class FragmenterReassembler(FragmenterOps):
                     None,
                 ]
 
-           Callback that is called when a timer task needs to be scheduled. May be None.
+           Callback that is called when a timer task needs to be scheduled.
 
         .. py:attribute:: remove_timer_entry
            :type: typing.Callable[[FragmentationConnection], None]
 
-           Callback that is called when a timer task needs to be canceled. May be None.
+           Callback that is called when a timer task needs to be canceled.
         """
+        if post_timer_task is None and remove_timer_entry is None:
+            timer_wheel = default_timer_wheel()
+            post_timer_task = timer_wheel.post_timer_task
+            remove_timer_entry = timer_wheel.remove_timer_entry
         super().__init__(
             end_rx=end_rx,
             end_tx=self._end_fragmentation_tx,
@@ -112,9 +246,20 @@ class FragmenterReassembler(FragmenterOps):
         self.mode = mode
         self._conn = self.conn_cls(ops=self)
         self._init_tx = False
+        self._tx_bit_array = None
         self._tx_conn_lock = threading.RLock()
         self._rx_conn_lock = threading.Lock()
 
+    def _load_tx_bit_array(self, data: bytes) -> BitArray:
+        # only call with self._tx_conn_lock held; reuses one BitArray as
+        # pre-allocated arena for all transmissions of this fragmenter
+        if self._tx_bit_array is None:
+            self._tx_bit_array = BitArray(data)
+        else:
+            self._tx_bit_array.reserve(len(data))
+            self._tx_bit_array.load(data)
+        return self._tx_bit_array
+
     def _tx_conn_release(self):
         self._init_tx = False
         self._conn.reset()
@@ -160,6 +305,26 @@ class FragmenterReassembler(FragmenterOps):
         :retval STAY_ALIVE: If reassembly was completed, but the connection still is
             kept open, e.g., in case another ACK needs to be sent.
         """
+        with self._rx_conn_lock:
+            return self._input_locked(data)
+
+    def input_batch(
+        self, datagrams: typing.Sequence[typing.Union[bytes, BitArray]]
+    ) -> typing.List[ReassemblyStatus]:
+        """Handle a batch of incoming datagrams in one call.
+
+        The whole batch is handled under a single lock acquisition and looped over
+        ``schc_input()``/``schc_reassemble()`` with the GIL released (see
+        :meth:`pylibschc.libschc.FragmentationConnection.input_batch`), so a burst
+        of fragments (e.g. from one ``recvmmsg()`` call) costs one Python
+        round-trip instead of one per fragment.
+
+        :param datagrams: ACKs, fragments, or unfragmented packets.
+        :return: The status of reassembly (see
+            :meth:`FragmenterReassembler.input`) for each datagram, in the order of
+            ``datagrams``.
+        :raises MemoryError: If memory for fragment reception could not be allocated.
+        """
         with self._rx_conn_lock:
             if self.end_rx:
                 with self._tx_conn_lock:
@@ -167,45 +332,153 @@ class FragmenterReassembler(FragmenterOps):
                         self.device.device_id,
                         self.device.duty_cycle_ms,
                     )
-            new_conn = self._conn.input(data)
-            if new_conn is None:
-                # duplicate ACK received
-                return ReassemblyStatus.COMPLETED  # pragma: no cover
-            if new_conn == self._conn:
-                return ReassemblyStatus.ACK_HANDLED
-            if not new_conn.fragmented:
-                if self.end_rx:  # pragma: no cover
-                    self.end_rx(new_conn)
-                new_conn.reset()
-                return ReassemblyStatus.COMPLETED
-            return new_conn.reassemble()
-
-    def output(self, data: typing.Union[bytes, BitArray]) -> FragmentationResult:
+            events = self._conn.input_batch(datagrams)
+        statuses = [ReassemblyStatus.ONGOING] * len(datagrams)
+        for index, status, _ in events:
+            statuses[index] = status
+        return statuses
+
+    def _input_locked(
+        self, data: typing.Union[bytes, BitArray]
+    ) -> ReassemblyStatus:
+        if self.end_rx:
+            with self._tx_conn_lock:
+                self._conn.init_rx(
+                    self.device.device_id,
+                    self.device.duty_cycle_ms,
+                )
+        new_conn = self._conn.input(data)
+        if new_conn is None:
+            # duplicate ACK received
+            return ReassemblyStatus.COMPLETED  # pragma: no cover
+        if new_conn == self._conn:
+            return ReassemblyStatus.ACK_HANDLED
+        if not new_conn.fragmented:
+            if self.end_rx:  # pragma: no cover
+                self.end_rx(new_conn)
+            new_conn.reset()
+            return ReassemblyStatus.COMPLETED
+        return new_conn.reassemble()
+
+    def output(
+        self, data: typing.Union[bytes, memoryview, mmap.mmap, BitArray]
+    ) -> FragmentationResult:
         """Send ``data``, fragmented if necessary.
 
-        :param data: The data to send.
+        :param data: The data to send. :class:`memoryview` and :class:`mmap.mmap`
+            objects are sent zero-copy (see :meth:`pylibschc.libschc.BitArray.borrow`)
+            and must stay unmodified until the transmission has completed.
         :retval NO_FRAGMENTATION: If the packet was not fragmented.
         :retval SUCCESS: If the packet was fragmented.
         """
-        if isinstance(data, BitArray):
-            bit_array = data
-        else:
-            bit_array = BitArray(data)
         self._tx_conn_lock.acquire()  # pylint: disable=consider-using-with
-        self._init_tx = True
-        self._conn.init_tx(
-            self.device.device_id,
-            bit_array,
-            self.device.mtu,
-            self.device.duty_cycle_ms,
-            self.mode.value,
-        )
         try:
+            if isinstance(data, BitArray):
+                bit_array = data
+            elif isinstance(data, (memoryview, mmap.mmap)):
+                # e.g. an mmap'd file region is fragmented straight from the
+                # page cache without copying the payload into a per-connection
+                # buffer
+                bit_array = BitArray.borrow(data)
+            else:
+                bit_array = self._load_tx_bit_array(data)
+            self._init_tx = True
+            self._conn.init_tx(
+                self.device.device_id,
+                bit_array,
+                self.device.mtu,
+                self.device.duty_cycle_ms,
+                self.mode.value,
+            )
             res = self._conn.fragment()
             if res == FragmentationResult.NO_FRAGMENTATION:
                 self._end_fragmentation_tx(self._conn)
             return res
-        except Exception:  # pragma: no cover
+        except Exception:
+            self._tx_conn_release()
+            raise
+
+    def output_paced(
+        self, data: typing.Union[bytes, memoryview, mmap.mmap, BitArray]
+    ) -> FragmentationResult:
+        """Send ``data``, fragmented if necessary, pacing the whole transmission in
+        the calling thread.
+
+        In contrast to :meth:`FragmenterReassembler.output`, no timer task is
+        scheduled per sent fragment: inter-fragment duty-cycle pacing and ACK
+        timeouts are waited out in the calling thread, and the call blocks until the
+        transmission has completed. ACKs still need to be fed in concurrently via
+        :meth:`FragmenterReassembler.input` or
+        :meth:`FragmenterReassembler.input_batch`.
+
+        :param data: The data to send. :class:`memoryview` and :class:`mmap.mmap`
+            objects are sent zero-copy (see :meth:`pylibschc.libschc.BitArray.borrow`)
+            and must stay unmodified until the transmission has completed.
+        :retval NO_FRAGMENTATION: If the packet was not fragmented.
+        :retval SUCCESS: If the packet was fragmented.
+        """
+        self._tx_conn_lock.acquire()  # pylint: disable=consider-using-with
+        try:
+            if isinstance(data, BitArray):
+                bit_array = data
+            elif isinstance(data, (memoryview, mmap.mmap)):
+                # e.g. an mmap'd file region is fragmented straight from the
+                # page cache without copying the payload into a per-connection
+                # buffer
+                bit_array = BitArray.borrow(data)
+            else:
+                bit_array = self._load_tx_bit_array(data)
+            self._init_tx = True
+            self._conn.init_tx(
+                self.device.device_id,
+                bit_array,
+                self.device.mtu,
+                self.device.duty_cycle_ms,
+                self.mode.value,
+            )
+            res = self._conn.fragment_paced()
+            if res == FragmentationResult.NO_FRAGMENTATION:
+                self._end_fragmentation_tx(self._conn)
+            return res
+        except Exception:
+            self._tx_conn_release()
+            raise
+
+    def send_packet(
+        self, data: bytes, direction: Direction
+    ) -> typing.Tuple[CompressionResult, FragmentationResult]:
+        """Compress ``data`` and send it, fragmented if necessary, in one call.
+
+        Fuses :meth:`pylibschc.compressor.CompressorDecompressor.output` and
+        :meth:`FragmenterReassembler.output`: the compression result is fragmented
+        in place, without an intermediate buffer copy or Python round-trip between
+        the two stages.
+
+        :param data: The packet to compress and send.
+        :param direction: Direction to use for compression.
+        :raise ValueError: When direction is :attr:`pylibschc.libschc.Direction.BI`.
+        :return: Whether the packet was compressed and whether it was fragmented.
+        """
+        if direction == Direction.BI:
+            raise ValueError("direction must be either UP or DOWN, not BI")
+        self._tx_conn_lock.acquire()  # pylint: disable=consider-using-with
+        self._init_tx = True
+        if self._tx_bit_array is None:
+            self._tx_bit_array = BitArray(0)
+        try:
+            comp_res, frag_res = self._conn.send_packet(
+                data,
+                self.device.__inner__,
+                direction,
+                self.device.mtu,
+                self.device.duty_cycle_ms,
+                self.mode.value,
+                self._tx_bit_array,
+            )
+            if frag_res == FragmentationResult.NO_FRAGMENTATION:
+                self._end_fragmentation_tx(self._conn)
+            return comp_res, frag_res
+        except Exception:
             self._tx_conn_release()
             raise
 
@@ -219,3 +492,191 @@ class FragmenterReassembler(FragmenterOps):
     def unregister_send(self):
         """Remove a send function for the device of this fragmenter."""
         return self.conn_cls.unregister_send(self.device.device_id)
+
+    def register_send_socket(self, sock: typing.Union[int, socket.socket]):
+        """Register a connected datagram socket as send fast path for the device of
+        this fragmenter.
+
+        Fragments are then written to the socket with ``send(2)`` directly from C,
+        without entering Python or allocating per fragment. Takes precedence over a
+        callable registered with :meth:`FragmenterReassembler.register_send`.
+
+        :param sock: A connected datagram socket (or its file descriptor).
+        """
+        fileno = sock if isinstance(sock, int) else sock.fileno()
+        return self.conn_cls.register_send_socket(self.device.device_id, fileno)
+
+    def unregister_send_socket(self):
+        """Remove the send fast path for the device of this fragmenter."""
+        return self.conn_cls.unregister_send_socket(self.device.device_id)
+
+    def register_send_mmsg(self, sock: typing.Union[int, socket.socket]):
+        """Register a connected datagram socket as batched scatter-gather send
+        backend for the device of this fragmenter.
+
+        Fragments are staged in C and reach the socket in batches of up to
+        :py:data:`pylibschc.libschc.SCHC_SEND_MMSG_BATCH` with one
+        ``sendmmsg(2)`` call — when the batch is full, when the transmission
+        ends, or on :meth:`FragmenterReassembler.flush_send` — so a whole
+        window of fragments costs one syscall and no per-fragment ``bytes``
+        object. Since fragments are held back until then, this backend suits
+        NO_ACK transfers on links without duty cycle rather than paced or
+        ACK'd ones. Takes precedence over a callable registered with
+        :meth:`FragmenterReassembler.register_send`; remove with
+        :meth:`FragmenterReassembler.unregister_send_socket`.
+
+        :param sock: A connected datagram socket (or its file descriptor).
+        """
+        fileno = sock if isinstance(sock, int) else sock.fileno()
+        return self.conn_cls.register_send_mmsg(self.device.device_id, fileno)
+
+    def flush_send(self) -> int:
+        """Send out any fragments staged by the batched send backend of the
+        device of this fragmenter.
+
+        :raise OSError: If sending failed.
+        :return: The number of fragments flushed.
+        """
+        return self.conn_cls.flush_send(self.device.device_id)
+
+
+class AsyncFragmenterReassembler(FragmenterReassembler):
+    """An asyncio-native :class:`FragmenterReassembler`.
+
+    Fragmentation timers are scheduled as ``loop.call_later()`` handles on one
+    event loop instead of a timer-wheel thread, ``send``/``end_rx``/``end_tx``
+    may be coroutine functions that are scheduled as tasks on that loop, and
+    :meth:`AsyncFragmenterReassembler.output` is a coroutine that resolves when
+    the whole transmission has completed — so many concurrent transfers
+    multiplex on one event loop without per-fragment executor round-trips.
+
+    All driving calls (:meth:`AsyncFragmenterReassembler.output`,
+    :meth:`FragmenterReassembler.input`,
+    :meth:`FragmenterReassembler.input_batch`) must be made from the thread
+    running the event loop."""
+
+    def __init__(  # pylint: disable=too-many-arguments
+        self,
+        device: pylibschc.device.Device,
+        mode: FragmentationMode = None,
+        end_rx: typing.Callable[[FragmentationConnection], None] = None,
+        end_tx: typing.Callable[[FragmentationConnection], None] = None,
+        loop: asyncio.AbstractEventLoop = None,
+    ):
+        """
+        :param device: The device to use for fragmentation/reassembly.
+        :param mode: (optional) The :class:`pylibschc.libschc.FragmentationMode` to
+            use.
+        :param end_rx: (optional) Callback or coroutine function that is called when
+            the reception of a packet is complete. A coroutine function is scheduled
+            as a task on the event loop.
+        :param end_tx: (optional) Callback or coroutine function that is called when
+            the transmission of a packet is complete. A coroutine function is
+            scheduled as a task on the event loop.
+        :param loop: (optional) The event loop to schedule timers and coroutines on.
+            Defaults to the running event loop of the first call that needs it.
+        """
+        self._loop = loop
+        self._timer_handles = {}
+        self._tx_future = None
+        self._tx_async_lock = None
+        super().__init__(
+            device=device,
+            mode=mode,
+            end_rx=self._wrap_callback(end_rx),
+            end_tx=self._wrap_callback(end_tx),
+            post_timer_task=self._post_timer_task,
+            remove_timer_entry=self._remove_timer_entry,
+        )
+
+    def _get_loop(self) -> asyncio.AbstractEventLoop:
+        if self._loop is None:
+            self._loop = asyncio.get_event_loop()
+        return self._loop
+
+    def _wrap_callback(self, callback):
+        if callback is None or not asyncio.iscoroutinefunction(callback):
+            return callback
+
+        def _schedule(conn: FragmentationConnection):
+            asyncio.ensure_future(callback(conn), loop=self._get_loop())
+
+        return _schedule
+
+    def _post_timer_task(
+        self,
+        conn: FragmentationConnection,
+        timer_task: typing.Callable[[object], None],
+        delay_sec: float,
+        arg: object,
+    ):
+        self._remove_timer_entry(conn)
+
+        def _fire():
+            self._timer_handles.pop(conn, None)
+            timer_task(arg)
+
+        self._timer_handles[conn] = self._get_loop().call_later(delay_sec, _fire)
+
+    def _remove_timer_entry(self, conn: FragmentationConnection):
+        handle = self._timer_handles.pop(conn, None)
+        if handle is not None:
+            handle.cancel()
+
+    def _end_fragmentation_tx(self, conn: FragmentationConnection):
+        future = self._tx_future
+        self._tx_future = None
+        if future is not None and not future.done():
+            future.set_result(None)
+        super()._end_fragmentation_tx(conn)
+
+    def register_send(self, send):
+        """Register a send function or coroutine function for the device of this
+        fragmenter.
+
+        A coroutine function is scheduled as a task on the event loop for every
+        fragment, e.g. to drain into a transport, and the fragment is reported to
+        the C layer as fully sent.
+
+        :param send: The send function or coroutine function for ``device``.
+        """
+        if asyncio.iscoroutinefunction(send):
+            coro_send = send
+
+            def _send(buffer: bytes) -> int:
+                asyncio.ensure_future(coro_send(buffer), loop=self._get_loop())
+                return len(buffer)
+
+            return super().register_send(_send)
+        return super().register_send(send)
+
+    async def output(
+        self, data: typing.Union[bytes, memoryview, mmap.mmap, BitArray]
+    ) -> FragmentationResult:
+        """Send ``data``, fragmented if necessary, and wait for the transmission to
+        complete.
+
+        Fragment pacing and ACK timeouts are driven by event-loop timers, so the
+        coroutine never blocks the loop; it resolves once the end of the transfer
+        was signaled (after the last fragment for timer-driven modes, including the
+        ACK exchanges of the mode used).
+
+        :param data: The data to send (see :meth:`FragmenterReassembler.output`).
+        :retval NO_FRAGMENTATION: If the packet was not fragmented.
+        :retval SUCCESS: If the packet was fragmented.
+        """
+        if self._tx_async_lock is None:
+            self._tx_async_lock = asyncio.Lock()
+        # serialize transfers on the loop instead of the (reentrant) thread lock
+        # of the synchronous API, which would not guard two coroutines on the
+        # same thread against each other
+        async with self._tx_async_lock:
+            future = self._get_loop().create_future()
+            self._tx_future = future
+            try:
+                res = super().output(data)
+            except Exception:
+                self._tx_future = None
+                raise
+            await future
+            return res
@@ -57,13 +57,15 @@
 import abc
 import enum
 import logging
+import threading
+import time
 import typing
 
 from cpython.bool cimport bool
 from cython.operator cimport postincrement as inc, postdecrement as dec
 from libc.stddef cimport size_t
-from libc.stdint cimport int8_t, uint8_t, uint16_t, uint32_t, intptr_t
-from libc.stdlib cimport free, malloc
+from libc.stdint cimport int8_t, uint8_t, uint16_t, uint32_t, uint64_t, intptr_t
+from libc.stdlib cimport free, malloc, realloc
 from libc.string cimport memcmp, memcpy, memset
 
 from . cimport clibschc
@@ -83,6 +85,7 @@ MAX_MTU_LENGTH = clibschc.MAX_MTU_LENGTH
 FCN_SIZE_BITS = clibschc.FCN_SIZE_BITS
 DTAG_SIZE_BITS = clibschc.DTAG_SIZE_BITS
 BITMAP_SIZE_BITS = clibschc.BITMAP_SIZE_BYTES * 8
+SCHC_SEND_MMSG_BATCH = clibschc.SCHC_SEND_MMSG_BATCH
 
 logger = logging.getLogger(__name__)
 
@@ -98,15 +101,20 @@ cdef class BitArray:
     :raise MemoryError: if internal memory for `BitArray.buffer` can not be allocated.
     """
     cdef clibschc.schc_bitarray_t _bit_array
+    cdef const uint8_t[::1] _view
+    cdef size_t _capacity
+    cdef bint _borrowed
     cdef public size_t size
     """Maximum size in bytes of the memory used for :attr:`BitArray.buffer`."""
 
     def __cinit__(self, n: typing.Union[bytes, int]):
+        self._borrowed = False
         self.size = len(n) if isinstance(n, bytes) else n
-        self._bit_array.ptr = <uint8_t *>malloc(self.size)
-        if self._bit_array.ptr is NULL:
-            raise MemoryError("Unable to allocate bit array")
+        self._capacity = self.size
         if self.size > 0:
+            self._bit_array.ptr = <uint8_t *>malloc(self.size)
+            if self._bit_array.ptr is NULL:
+                raise MemoryError("Unable to allocate bit array")
             if isinstance(n, bytes):
                 memcpy(<void *>self._bit_array.ptr, <char *>n, self.size)
             else:
@@ -122,7 +130,58 @@ cdef class BitArray:
             self._bit_array.bit_len = 0
 
     def __dealloc__(self):
-        free(<void *>self._bit_array.ptr)
+        if not self._borrowed:
+            free(<void *>self._bit_array.ptr)
+
+    @staticmethod
+    def borrow(data) -> BitArray:
+        """Create a :class:`BitArray` that borrows ``data`` instead of copying it.
+
+        The returned :class:`BitArray` references the memory of ``data`` directly
+        (and keeps ``data`` alive), so, e.g., an :class:`mmap.mmap`'d file region can
+        be fragmented straight from the page cache without the payload ever being
+        duplicated into a per-connection buffer. A borrowed :class:`BitArray` is
+        read-only: all mutating operations raise :class:`ValueError`.
+
+        :param data: The object to borrow the buffer of. May be any object
+            implementing the buffer protocol.
+        :raise TypeError: When ``data`` does not implement the buffer protocol.
+        :return: A read-only :class:`BitArray` viewing the memory of ``data``.
+        :rtype: :class:`BitArray`
+        """
+        cdef BitArray res = BitArray(0)
+        cdef const uint8_t[::1] view = data
+
+        res._view = view
+        if view.shape[0] > 0:
+            res._bit_array.ptr = <uint8_t *>&view[0]
+        res._borrowed = True
+        res._capacity = view.shape[0]
+        res.size = view.shape[0]
+        res._bit_array.len = view.shape[0]
+        res._bit_array.bit_len = view.shape[0] * 8
+        return res
+
+    cdef int _check_writable(self) except -1:
+        if self._borrowed:
+            raise ValueError("BitArray borrows its buffer and is read-only")
+        return 0
+
+    cdef int _reserve(self, size_t capacity) except -1:
+        cdef uint8_t *ptr
+
+        if capacity <= self._capacity:
+            return 0
+        self._check_writable()
+        # grow geometrically so repeated growth is amortized constant per byte
+        if capacity < (2 * self._capacity):
+            capacity = 2 * self._capacity
+        ptr = <uint8_t *>realloc(<void *>self._bit_array.ptr, capacity)
+        if ptr is NULL:
+            raise MemoryError("Unable to allocate bit array")
+        self._bit_array.ptr = ptr
+        self._capacity = capacity
+        return 0
 
     cdef int _eq(self, BitArray other):
         return (
@@ -160,17 +219,11 @@ cdef class BitArray:
             return <bytes> self._bit_array.ptr[:self._bit_array.len]
 
         def __set__(self, buffer: bytes):
+            self._check_writable()
+            self._reserve(len(buffer))
             if len(buffer) > self.size:
                 self.size = len(buffer)
-                free(<void *>self._bit_array.ptr)
-                self._bit_array.ptr = <uint8_t *>malloc(self.size)
-                if self._bit_array.ptr is NULL:
-                    raise MemoryError("Unable to allocate bit array")
-            elif len(buffer) == 0:
-                self.size = 0
-                free(<void *>self._bit_array.ptr)
-                self._bit_array.ptr = NULL
-            if self.size > 0:
+            if len(buffer) > 0:
                 memcpy(
                     <void *>self._bit_array.ptr, <void *>(<char *>buffer), len(buffer)
                 )
@@ -178,12 +231,19 @@ cdef class BitArray:
             self._bit_array.bit_len = len(buffer) * 8
 
         def __del__(self):
+            self._check_writable()
             memset(<void *>self._bit_array.ptr, 0, self.size)
             self._bit_array.offset = 0
             self._bit_array.padding = 0
             self._bit_array.len = 0
             self._bit_array.bit_len = 0
 
+    property capacity:
+        """Number of bytes allocated for :attr:`BitArray.buffer`. May be larger than
+        :attr:`BitArray.size` after the :class:`BitArray` has grown."""
+        def __get__(self) -> int:
+            return self._capacity
+
     property offset:
         """Offset in bits within :attr:`BitArray.buffer`."""
         def __get__(self) -> int:
@@ -209,6 +269,69 @@ cdef class BitArray:
         def __get__(self) -> int:
             return self._bit_array.bit_len
 
+    def reserve(self, capacity: int):
+        """Grow the backing store to at least ``capacity`` bytes.
+
+        Growth is geometric, so repeatedly reserving ever larger capacities is
+        amortized constant per byte. Never shrinks and does not change
+        :attr:`BitArray.size` or the content of :attr:`BitArray.buffer`.
+
+        :param capacity: Minimum number of bytes to allocate for
+            :attr:`BitArray.buffer`.
+        :type capacity: :class:`int`
+        :raise ValueError: If ``capacity`` is lesser than 0.
+        :raise MemoryError: If internal memory for :attr:`BitArray.buffer` can not be
+            allocated.
+        """
+        if capacity < 0:
+            raise ValueError("`capacity` must be greater or equal to 0")
+        self._reserve(capacity)
+
+    def clear(self):
+        """Reset the :class:`BitArray` to an empty, all-zero state.
+
+        In contrast to ``del`` :attr:`BitArray.buffer` or assigning a new buffer,
+        this never frees or allocates memory; :attr:`BitArray.capacity` is kept, so
+        the :class:`BitArray` can be reused as a pre-allocated arena.
+
+        :raise ValueError: If the buffer is borrowed (see :meth:`BitArray.borrow`).
+        """
+        self._check_writable()
+        if self._bit_array.ptr is not NULL:
+            memset(<void *>self._bit_array.ptr, 0, self._capacity)
+        self._bit_array.offset = 0
+        self._bit_array.padding = 0
+        self._bit_array.len = 0
+        self._bit_array.bit_len = 0
+
+    def load(self, buffer: bytes):
+        """Copy ``buffer`` into the existing :attr:`BitArray.capacity`.
+
+        In contrast to assigning to :attr:`BitArray.buffer`, this never allocates;
+        use :meth:`BitArray.reserve` beforehand if the capacity might not suffice.
+
+        :param buffer: The bytes to copy into :attr:`BitArray.buffer`.
+        :type buffer: :class:`bytes`
+        :raise ValueError: If ``buffer`` is larger than :attr:`BitArray.capacity`.
+        :raise ValueError: If the buffer is borrowed (see :meth:`BitArray.borrow`).
+        """
+        self._check_writable()
+        if <size_t>len(buffer) > self._capacity:
+            raise ValueError(
+                f"`buffer` (length {len(buffer)}) exceeds capacity "
+                f"({self._capacity})"
+            )
+        if len(buffer) > 0:
+            memcpy(
+                <void *>self._bit_array.ptr, <void *>(<char *>buffer), len(buffer)
+            )
+        if <size_t>len(buffer) > self.size:
+            self.size = len(buffer)
+        self._bit_array.offset = 0
+        self._bit_array.padding = 0
+        self._bit_array.len = len(buffer)
+        self._bit_array.bit_len = len(buffer) * 8
+
     def get_bits(self, pos: int, length: int) -> int:
         """Get at a maximum 32 bits from the :class:`BitArray` as integer.
 
@@ -236,7 +359,7 @@ cdef class BitArray:
             raise ValueError(
                 f"`pos + length` overflows buffer size ({self._bit_array.bit_len})"
             )
-        return clibschc.get_bits(self._bit_array.ptr, pos, length)
+        return clibschc.pybits_get(self._bit_array.ptr, pos, length)
 
     def copy_bits(self, pos: int, data: bytes, length: int) -> int:
         """Copy bits to :attr:`BitArray.buffer`.
@@ -253,7 +376,9 @@ cdef class BitArray:
         :raise ValueError: If ``pos`` is lesser than 0.
         :raise ValueError: If ``pos + length`` is greater than
             :attr:`BitArray.bit_length`.
+        :raise ValueError: If the buffer is borrowed (see :meth:`BitArray.borrow`).
         """
+        self._check_writable()
         if length < 0:
             raise ValueError("`length` must be greater or equal to 0")
         if pos < 0:
@@ -262,8 +387,7 @@ cdef class BitArray:
             raise ValueError(
                 f"`pos + length` overflows buffer size ({self._bit_array.bit_len})"
             )
-        clibschc.clear_bits(self._bit_array.ptr, pos, length)
-        clibschc.copy_bits(
+        clibschc.pybits_overwrite(
             self._bit_array.ptr, pos, <uint8_t *>(<char *>data), 0, length
         )
 
@@ -378,27 +502,53 @@ cdef class Device:
     _devices = {}
 
     cdef clibschc.schc_device _dev
+    cdef readonly object lock
+    """Mutex serializing libSCHC compression/decompression calls for this device.
+    Held while the GIL is released around ``schc_compress()``/``schc_decompress()``,
+    so concurrent calls on different devices may run in parallel."""
+    cdef public bint promote_matched_rules
+    """When True, a rule matched by :meth:`CompressorDecompressor.compress` is moved
+    to the front of the compression context (default: False), so flow-skewed traffic
+    matches its hot rule on the first try instead of scanning the whole context.
+    Note that this reorders the compression context in place; when several rules match
+    a packet, the promoted rule is picked over earlier-listed ones."""
+    cdef list _retired_frag_contexts
+    # scratch buffer for decompression on this device; serialized by `lock`,
+    # so decompression on different devices may run in parallel
+    cdef uint8_t *_decomp_buf
 
     def __cinit__(self, device_id: int):
+        self._decomp_buf = <uint8_t *>malloc(clibschc.MAX_MTU_LENGTH)
+        if self._decomp_buf is NULL:
+            raise MemoryError("Unable to allocate decompression buffer")
         self._dev.device_id = device_id
+        self.lock = threading.Lock()
+        self.promote_matched_rules = False
+        self._retired_frag_contexts = []
         self._register()
 
     def __dealloc__(self):
         self._unregister()
+        free(self._decomp_buf)
 
     cdef _register(self):
-        for i in range(clibschc.DEVICE_COUNT):
-            if clibschc.devices[i] == &self._dev:
-                return
-            if clibschc.devices[i].device_id == self._dev.device_id:
-                raise ValueError(
-                    f"There is already a device with ID #{self._dev.device_id}"
-                )
+        cdef clibschc.schc_device *indexed = clibschc.schc_rules_get_device_by_id(
+            self._dev.device_id
+        )
+        if indexed == &self._dev:
+            return
+        if indexed is not NULL:
+            raise ValueError(
+                f"There is already a device with ID #{self._dev.device_id}"
+            )
         cdef clibschc.schc_device **new_devices = <clibschc.schc_device **>malloc(
             (clibschc.DEVICE_COUNT + 1) * sizeof(clibschc.schc_device *)
         )
         if new_devices is NULL:
             raise MemoryError("Error allocating new device #{self._dev.device_id}")
+        if clibschc.schc_rules_device_index_add(&self._dev) < 0:
+            free(new_devices)
+            raise MemoryError("Error allocating new device #{self._dev.device_id}")
         if clibschc.devices is not NULL:
             for i in range(clibschc.DEVICE_COUNT):
                 new_devices[i] = clibschc.devices[i]
@@ -408,15 +558,68 @@ cdef class Device:
         clibschc.devices = new_devices
         self._devices[self._dev.device_id] = self
 
+    cdef _swap_compr_context(
+        self, clibschc.schc_compression_rule_t **context, unsigned rule_count
+    ):
+        cdef clibschc.schc_compression_rule_t **old_context
+        cdef unsigned old_count
+
+        with self.lock:
+            old_context = <clibschc.schc_compression_rule_t **>(
+                self._dev.compression_context
+            )
+            old_count = self._dev.compression_rule_count
+            self._dev.compression_context = context
+            self._dev.compression_rule_count = rule_count
+        # every reader of the compression context holds self.lock, so all of
+        # them have drained once the swap is published
+        if old_context is not NULL:
+            clibschc.schc_rules_free_compr_ctx(old_context, old_count)
+
+    cdef _swap_frag_context(
+        self, clibschc.schc_fragmentation_rule_t **context, unsigned rule_count
+    ):
+        cdef clibschc.schc_fragmentation_rule_t **old_context
+
+        with self.lock:
+            old_context = <clibschc.schc_fragmentation_rule_t **>(
+                self._dev.fragmentation_context
+            )
+            old_count = self._dev.fragmentation_rule_count
+            self._dev.fragmentation_context = context
+            self._dev.fragmentation_rule_count = rule_count
+        # in contrast to the compression context, the fragmentation context is
+        # also read by schc_input() without holding self.lock; retire the old
+        # context and only free it on the swap after the next one, when any
+        # reader that could still see it has long drained
+        self._free_retired_frag_contexts(keep=1)
+        if old_context is not NULL:
+            self._retired_frag_contexts.append(
+                (<intptr_t><void *>old_context, old_count)
+            )
+
+    cdef _free_retired_frag_contexts(self, keep=0):
+        while len(self._retired_frag_contexts) > keep:
+            ctx, count = self._retired_frag_contexts.pop(0)
+            clibschc.schc_rules_free_frag_ctx(
+                <clibschc.schc_fragmentation_rule_t **>(
+                    <void *><intptr_t>ctx
+                ),
+                <unsigned>count
+            )
+
     cdef _unregister(self):
         if clibschc.devices is NULL:
             return
         del self.compression_rules
+        del self.fragmentation_rules
+        self._free_retired_frag_contexts()
         for i in range(clibschc.DEVICE_COUNT):
             if clibschc.devices[i].device_id == self._dev.device_id:
                 for j in range(i, clibschc.DEVICE_COUNT - 1):
                     clibschc.devices[j] = clibschc.devices[j + 1]
                 dec(clibschc.DEVICE_COUNT)
+                clibschc.schc_rules_device_index_remove(self._dev.device_id)
                 break
         if clibschc.DEVICE_COUNT == 0 and clibschc.devices is not NULL:
             free(clibschc.devices)
@@ -554,8 +757,12 @@ cdef class Device:
 
     @staticmethod
     cdef _set_compression_rule(
-        dict layer_rules, clibschc.schc_compression_rule_t *c_rule, dict py_rule
+        dict layer_rules,
+        clibschc.schc_compression_rule_t **ctx,
+        int i,
+        dict py_rule
     ):
+        cdef clibschc.schc_compression_rule_t *c_rule = ctx[i]
         c_rule.rule_id = py_rule["rule_id"]
         c_rule.rule_id_size_bits = py_rule["rule_id_size_bits"]
         try:
@@ -564,7 +771,7 @@ cdef class Device:
                     if rule == py_rule["ipv6_rule"]:
                         c_rule.ipv6_rule = <clibschc.schc_ipv6_rule_t *>(<intptr_t>ptr)
                 if not c_rule.ipv6_rule:
-                    c_rule.ipv6_rule = clibschc.schc_rules_create_ipv6_rule()
+                    c_rule.ipv6_rule = clibschc.schc_rules_create_ipv6_rule(ctx)
                     Device._set_layer_rule(
                         <clibschc.schc_layer_rule_t *>c_rule.ipv6_rule,
                         py_rule["ipv6_rule"],
@@ -576,7 +783,7 @@ cdef class Device:
                     if rule == py_rule["udp_rule"]:
                         c_rule.udp_rule = <clibschc.schc_udp_rule_t *>(<intptr_t>ptr)
                 if not c_rule.udp_rule:
-                    c_rule.udp_rule = clibschc.schc_rules_create_udp_rule()
+                    c_rule.udp_rule = clibschc.schc_rules_create_udp_rule(ctx)
                     Device._set_layer_rule(
                         <clibschc.schc_layer_rule_t *>c_rule.udp_rule,
                         py_rule["udp_rule"],
@@ -588,7 +795,7 @@ cdef class Device:
                     if rule == py_rule["coap_rule"]:
                         c_rule.coap_rule = <clibschc.schc_coap_rule_t *>(<intptr_t>ptr)
                 if not c_rule.coap_rule:
-                    c_rule.coap_rule = clibschc.schc_rules_create_coap_rule()
+                    c_rule.coap_rule = clibschc.schc_rules_create_coap_rule(ctx)
                     Device._set_layer_rule(
                         <clibschc.schc_layer_rule_t *>c_rule.coap_rule,
                         py_rule["coap_rule"],
@@ -650,35 +857,28 @@ cdef class Device:
             return res
 
         def __set__(self, rules: typing.Optional[typing.Sequence[dict]]):
-            if self._dev.compression_context:
-                clibschc.schc_rules_free_compr_ctx(
-                    <clibschc.schc_compression_rule_t **>self._dev.compression_context,
-                    self._dev.compression_rule_count
-                )
+            cdef clibschc.schc_compression_rule_t **context = NULL
+            cdef unsigned rule_count = 0
+
+            # build the new context fully before unpublishing the old one, so a
+            # compression running concurrently never sees a partially built or
+            # freed context
             if rules:
-                rule_count = len(rules)
-                context = clibschc.schc_rules_create_compr_ctx(<unsigned>len(rules))
+                rule_count = <unsigned>len(rules)
+                context = clibschc.schc_rules_create_compr_ctx(rule_count)
                 try:
                     layer_rules = {}
                     for i, py_rule in enumerate(rules):
-                        Device._set_compression_rule(layer_rules, context[i], py_rule)
+                        Device._set_compression_rule(
+                            layer_rules, context, <int>i, py_rule
+                        )
                 except ValueError:
                     clibschc.schc_rules_free_compr_ctx(context, rule_count)
                     raise
-                else:
-                    self._dev.compression_context = context
-                    self._dev.compression_rule_count = rule_count
-            else:
-                self._dev.compression_context = NULL
-                self._dev.compression_rule_count = 0
+            self._swap_compr_context(context, rule_count)
 
         def __del__(self):
-            clibschc.schc_rules_free_compr_ctx(
-                <clibschc.schc_compression_rule_t **>self._dev.compression_context,
-                self._dev.compression_rule_count
-            )
-            self._dev.compression_context = NULL
-            self._dev.compression_rule_count = 0
+            self._swap_compr_context(NULL, 0)
 
     property device_id:
         """
@@ -707,35 +907,24 @@ cdef class Device:
             return res
 
         def __set__(self, rules: typing.Optional[typing.Sequence[dict]]):
-            if self._dev.fragmentation_context:
-                clibschc.schc_rules_free_frag_ctx(
-                    <clibschc.schc_fragmentation_rule_t **>
-                    self._dev.fragmentation_context,
-                    self._dev.fragmentation_rule_count
-                )
+            cdef clibschc.schc_fragmentation_rule_t **context = NULL
+            cdef unsigned rule_count = 0
+
+            # build the new context fully before unpublishing the old one, see
+            # the compression_rules setter
             if rules:
-                rule_count = len(rules)
-                context = clibschc.schc_rules_create_frag_ctx(<unsigned>len(rules))
+                rule_count = <unsigned>len(rules)
+                context = clibschc.schc_rules_create_frag_ctx(rule_count)
                 try:
                     for i, py_rule in enumerate(rules):
                         Device._set_fragmentation_rule(context[i], py_rule)
                 except ValueError:
                     clibschc.schc_rules_free_frag_ctx(context, rule_count)
                     raise
-                else:
-                    self._dev.fragmentation_context = context
-                    self._dev.fragmentation_rule_count = rule_count
-            else:
-                self._dev.fragmentation_context = NULL
-                self._dev.fragmentation_rule_count = 0
+            self._swap_frag_context(context, rule_count)
 
         def __del__(self):
-            clibschc.schc_rules_free_frag_ctx(
-                <clibschc.schc_fragmentation_rule_t **>self._dev.fragmentation_context,
-                self._dev.fragmentation_rule_count
-            )
-            self._dev.fragmentation_context = NULL
-            self._dev.fragmentation_rule_count = 0
+            self._swap_frag_context(NULL, 0)
 
     property uncompressed_rule_id:
         """
@@ -763,6 +952,240 @@ cdef class Device:
         def __set__(self, uncompressed_rule_id_size_bits: int):
             self._dev.uncomp_rule_id_size_bits = uncompressed_rule_id_size_bits
 
+    @staticmethod
+    cdef Py_ssize_t _load_binary_layer_rule(
+        clibschc.schc_layer_rule_t *c_layer_rule,
+        const uint8_t[::1] view,
+        Py_ssize_t pos,
+        int max_fields,
+    ) except -1:
+        cdef clibschc.schc_field *c_field
+        cdef uint8_t up = 0
+        cdef uint8_t down = 0
+        cdef uint8_t length
+        cdef uint8_t tv_len
+        cdef int mo
+
+        if (pos + 1) > view.shape[0]:
+            raise ValueError("truncated binary rule context")
+        length = view[pos]
+        pos += 1
+        if length > <unsigned>max_fields:
+            raise ValueError(f"layer rule contains more than {max_fields} fields")
+        for i in range(length):
+            if (pos + 9) > view.shape[0]:
+                raise ValueError("truncated binary rule context")
+            c_field = &c_layer_rule.content[i]
+            c_field.field = view[pos] | (view[pos + 1] << 8)
+            c_field.MO_param_length = view[pos + 2]
+            c_field.field_length = view[pos + 3]
+            c_field.field_pos = view[pos + 4]
+            if view[pos + 5] > <unsigned>clibschc.BI:
+                raise ValueError(f"unknown direction {view[pos + 5]}")
+            c_field.dir = <clibschc.direction>view[pos + 5]
+            mo = view[pos + 6]
+            if view[pos + 7] > <unsigned>clibschc.APPIID:
+                raise ValueError(f"unknown action {view[pos + 7]}")
+            c_field.action = <clibschc.CDA>view[pos + 7]
+            tv_len = view[pos + 8]
+            pos += 9
+            if tv_len > clibschc.MAX_FIELD_LENGTH:
+                raise ValueError(
+                    f"target_value is longer than MAX_FIELD_LENGTH "
+                    f"({clibschc.MAX_FIELD_LENGTH})"
+                )
+            if (pos + tv_len) > view.shape[0]:
+                raise ValueError("truncated binary rule context")
+            memset(c_field.target_value, 0, clibschc.MAX_FIELD_LENGTH)
+            if tv_len > 0:
+                memcpy(c_field.target_value, <const void *>&view[pos], tv_len)
+            pos += tv_len
+            _set_mo_op(c_field, mo)
+            if c_field.dir == clibschc.UP:
+                inc(up)
+            elif c_field.dir == clibschc.DOWN:
+                inc(down)
+            else:  # c_field.dir == clibschc.BI
+                inc(up)
+                inc(down)
+        c_layer_rule.up = up
+        c_layer_rule.down = down
+        c_layer_rule.length = length
+        return pos
+
+    def load_rules_binary(self, buf: typing.Union[bytes, bytearray, memoryview]):
+        """Load the compression context of this device from its packed binary form.
+
+        In contrast to setting :attr:`Device.compression_rules`, this copies the field
+        descriptors straight into the compression context without any per-rule Python
+        object traversal, making bulk rule loading an O(bytes) operation.
+
+        The packed format, as produced by :meth:`Device.dump_rules_binary`, is a byte
+        stream with all multi-byte integers little-endian::
+
+            context := rule_count:u8 rule{rule_count}
+            rule    := rule_id:u32 rule_id_size_bits:u8 layers:u8 layer{...}
+            layer   := length:u8 field{length}
+            field   := field:u16 MO_param_length:u8 field_length:u8 field_pos:u8
+                       dir:u8 MO:u8 action:u8 tv_len:u8 target_value:u8{tv_len}
+
+        ``layers`` is a bit mask marking which layer rules are present (bit 0: IPv6,
+        bit 1: UDP, bit 2: CoAP); present layers follow in that order. ``MO`` is the
+        value of a :class:`MO` member.
+
+        :param buf: The packed binary compression context.
+        :type buf: :class:`typing.Union[bytes, bytearray, memoryview]`
+        :raise TypeError: When ``buf`` does not implement the buffer protocol.
+        :raise ValueError: When ``buf`` is truncated or contains invalid rule
+            definitions.
+        :raise MemoryError: If internal memory for the compression context can not be
+            allocated.
+        """
+        cdef const uint8_t[::1] view = buf
+        cdef Py_ssize_t pos = 1
+        cdef Py_ssize_t end = view.shape[0]
+        cdef clibschc.schc_compression_rule_t **context = NULL
+        cdef clibschc.schc_compression_rule_t *c_rule
+        cdef unsigned rule_count
+        cdef uint8_t layers
+
+        if end < 1:
+            raise ValueError("truncated binary rule context")
+        rule_count = view[0]
+        if rule_count == 0:
+            del self.compression_rules
+            return
+        context = clibschc.schc_rules_create_compr_ctx(rule_count)
+        if context is NULL:
+            raise MemoryError("Unable to allocate compression context")
+        try:
+            for i in range(rule_count):
+                if (pos + 6) > end:
+                    raise ValueError("truncated binary rule context")
+                c_rule = context[i]
+                c_rule.rule_id = (
+                    view[pos]
+                    | (view[pos + 1] << 8)
+                    | (view[pos + 2] << 16)
+                    | (view[pos + 3] << 24)
+                )
+                c_rule.rule_id_size_bits = view[pos + 4]
+                layers = view[pos + 5]
+                pos += 6
+                if layers & 0x1:
+                    c_rule.ipv6_rule = clibschc.schc_rules_create_ipv6_rule(context)
+                    pos = Device._load_binary_layer_rule(
+                        <clibschc.schc_layer_rule_t *>c_rule.ipv6_rule,
+                        view,
+                        pos,
+                        clibschc.IP6_FIELDS
+                    )
+                if layers & 0x2:
+                    c_rule.udp_rule = clibschc.schc_rules_create_udp_rule(context)
+                    pos = Device._load_binary_layer_rule(
+                        <clibschc.schc_layer_rule_t *>c_rule.udp_rule,
+                        view,
+                        pos,
+                        clibschc.UDP_FIELDS
+                    )
+                if layers & 0x4:
+                    c_rule.coap_rule = clibschc.schc_rules_create_coap_rule(context)
+                    pos = Device._load_binary_layer_rule(
+                        <clibschc.schc_layer_rule_t *>c_rule.coap_rule,
+                        view,
+                        pos,
+                        clibschc.COAP_FIELDS
+                    )
+            if pos != end:
+                raise ValueError("trailing data in binary rule context")
+        except Exception:
+            clibschc.schc_rules_free_compr_ctx(context, rule_count)
+            raise
+        self._swap_compr_context(context, rule_count)
+
+    @staticmethod
+    cdef _dump_binary_layer_rule(
+        bytearray res, const clibschc.schc_layer_rule_t *layer_rule
+    ):
+        cdef const clibschc.schc_field *c_field
+        cdef unsigned tv_len
+        cdef int mo
+
+        res.append(layer_rule.length)
+        for j in range(layer_rule.length):
+            c_field = &layer_rule.content[j]
+            if <void *>c_field.MO == <void *>clibschc.mo_equal:
+                mo = <int>MO.MO_EQUAL.value
+            elif <void *>c_field.MO == <void *>clibschc.mo_ignore:
+                mo = <int>MO.MO_IGNORE.value
+            elif <void *>c_field.MO == <void *>clibschc.mo_MSB:
+                mo = <int>MO.MO_MSB.value
+            elif <void *>c_field.MO == <void *>clibschc.mo_matchmap:
+                mo = <int>MO.MO_MATCHMAP.value
+            else:
+                raise ValueError("undefined match operator")
+            tv_len = clibschc.BITS_TO_BYTES(c_field.field_length)
+            if (
+                <int>c_field.action == <int>clibschc.MAPPINGSENT
+                or mo == <int>MO.MO_MATCHMAP.value
+            ):
+                tv_len *= c_field.MO_param_length
+            if tv_len > <unsigned>clibschc.MAX_FIELD_LENGTH:
+                # target_value only holds MAX_FIELD_LENGTH bytes
+                tv_len = clibschc.MAX_FIELD_LENGTH
+            res.append(c_field.field & 0xff)
+            res.append((c_field.field >> 8) & 0xff)
+            res.append(c_field.MO_param_length)
+            res.append(c_field.field_length)
+            res.append(c_field.field_pos)
+            res.append(<uint8_t>c_field.dir)
+            res.append(mo)
+            res.append(<uint8_t>c_field.action)
+            res.append(<uint8_t>tv_len)
+            res += <bytes>c_field.target_value[:tv_len]
+
+    def dump_rules_binary(self) -> bytes:
+        """Serialize the compression context of this device to its packed binary form.
+
+        See :meth:`Device.load_rules_binary` for the format.
+
+        :return: The packed binary compression context.
+        :rtype: :class:`bytes`
+        """
+        cdef const clibschc.schc_compression_rule_t *c_rule
+        cdef uint8_t layers
+
+        res = bytearray()
+        res.append(self._dev.compression_rule_count)
+        for i in range(self._dev.compression_rule_count):
+            c_rule = self._dev.compression_context[i]
+            res.append(c_rule.rule_id & 0xff)
+            res.append((c_rule.rule_id >> 8) & 0xff)
+            res.append((c_rule.rule_id >> 16) & 0xff)
+            res.append((c_rule.rule_id >> 24) & 0xff)
+            res.append(c_rule.rule_id_size_bits)
+            layers = 0
+            if c_rule.ipv6_rule:
+                layers |= 0x1
+            if c_rule.udp_rule:
+                layers |= 0x2
+            if c_rule.coap_rule:
+                layers |= 0x4
+            res.append(layers)
+            if c_rule.ipv6_rule:
+                Device._dump_binary_layer_rule(
+                    res, <const clibschc.schc_layer_rule_t *>c_rule.ipv6_rule
+                )
+            if c_rule.udp_rule:
+                Device._dump_binary_layer_rule(
+                    res, <const clibschc.schc_layer_rule_t *>c_rule.udp_rule
+                )
+            if c_rule.coap_rule:
+                Device._dump_binary_layer_rule(
+                    res, <const clibschc.schc_layer_rule_t *>c_rule.coap_rule
+                )
+        return bytes(res)
+
     def unregister(self):
         """Removes this device from the rule configuration of libSCHC."""
         self._unregister()
@@ -774,29 +1197,68 @@ class CompressionResult(enum.Enum):
     COMPRESSED = 1
 
 
+cdef void _promote_rule(
+    clibschc.schc_device *dev, clibschc.schc_compression_rule_t *rule
+) nogil:
+    # move `rule` to the front of the compression context, so libSCHC's in-order
+    # rule scan finds the hot rule of a flow-skewed workload on the first try
+    cdef clibschc.schc_compression_rule_t **context = (
+        <clibschc.schc_compression_rule_t **>dev.compression_context
+    )
+    cdef int i
+
+    if context is NULL:
+        return
+    for i in range(dev.compression_rule_count):
+        if context[i] == rule:
+            while i > 0:
+                context[i] = context[i - 1]
+                dec(i)
+            context[0] = rule
+            return
+
+
 cdef class CompressorDecompressor:
     """Compressor/Decompressor.
 
-    Wraps functionality of ``compressor.h`` of libSCHC."""
+    Wraps functionality of ``compressor.h`` of libSCHC.
+
+    ``schc_compress()``/``schc_decompress()`` are called with the GIL released and
+    serialized per device via :attr:`Device.lock`, so compression for different
+    devices may run concurrently on multiple cores."""
     @staticmethod
     def init():
         """Initialize compressor/decompressor module in libSCHC."""
         clibschc.schc_compressor_init()
 
     @staticmethod
-    def compress(data: bytes, device: Device, dir: Direction) -> tuple[
+    def compress(
+        data: typing.Union[bytes, bytearray, memoryview],
+        device: Device,
+        dir: Direction,
+        bit_arr: BitArray = None,
+    ) -> tuple[
         CompressionResult,
         BitArray
     ]:
         """Compress ``data`` for ``device`` in ``dir``.
 
-        :param data: The data to compress.
-        :type data: :class:`bytes`
+        :param data: The data to compress. May be any object implementing the buffer
+            protocol; ``data`` is read directly from the caller's memory, without an
+            intermediate copy.
+        :type data: :class:`typing.Union[bytes, bytearray, memoryview]`
         :param device: The device of which to use the compression context.
         :type device: :class:`Device`
         :param dir: The direction ``data`` is sent in.
         :type dir: :class:`Direction`
+        :param bit_arr: A :class:`BitArray` to re-use for the compression result. If
+            None, a new :class:`BitArray` is allocated. Must be large enough to hold
+            ``data`` and the uncompressed rule ID of ``device``.
+        :type bit_arr: :class:`BitArray`
+        :raise TypeError: When ``data`` does not implement the buffer protocol.
         :raise ValueError: When direction is :attr:`pylibschc.libschc.Direction.BI`.
+        :raise ValueError: When ``bit_arr`` is provided but too small for the
+            compression result.
         :return: Whether the packet was compressed or the uncompressed rule was used
             and the compressed packet as a :class:`BitArray`.
         :rtype: :class:`typing.Tuple` [
@@ -805,20 +1267,49 @@ cdef class CompressorDecompressor:
             ]
         """
         cdef clibschc.schc_compression_rule_t *rule
+        cdef const uint8_t[::1] buf = data
+        cdef const uint8_t *ptr = NULL
+        cdef uint16_t length = <uint16_t>buf.shape[0]
+        cdef uint32_t device_id
+        cdef clibschc.direction c_dir
+        cdef uint64_t t_0
 
         if <clibschc.direction>dir.value == <clibschc.direction>Direction.BI.value:
             raise ValueError("`dir` must be either UP or DOWN, not BI")
         # need at minimum length + rule length
-        bit_arr = BitArray(
-            len(data) + clibschc.BITS_TO_BYTES(device.uncompressed_rule_id_size_bits)
-        )
-        rule = clibschc.schc_compress(
-            <uint8_t *>(<char *>data),
-            len(data),
-            &bit_arr._bit_array,
-            device.device_id,
-            <clibschc.direction>dir.value
-        )
+        size = length + clibschc.BITS_TO_BYTES(device.uncompressed_rule_id_size_bits)
+        if bit_arr is None:
+            bit_arr = BitArray(size)
+        else:
+            if bit_arr.size < <size_t>size:
+                raise ValueError(
+                    f"`bit_arr` (size {bit_arr.size}) is too small for compression "
+                    f"result (up to {size} bytes)"
+                )
+            bit_arr._check_writable()
+            # restore the state of a freshly allocated BitArray of that size
+            memset(<void *>bit_arr._bit_array.ptr, 0, bit_arr.size)
+            bit_arr._bit_array.offset = 0
+            bit_arr._bit_array.padding = 0
+            bit_arr._bit_array.len = bit_arr.size
+            bit_arr._bit_array.bit_len = 0
+        if length > 0:
+            ptr = &buf[0]
+        device_id = <uint32_t>device.device_id
+        c_dir = <clibschc.direction>dir.value
+        with device.lock:
+            with nogil:
+                t_0 = clibschc.pystats_now_ns()
+                rule = clibschc.schc_compress(
+                    <uint8_t *>ptr,
+                    length,
+                    &bit_arr._bit_array,
+                    device_id,
+                    c_dir
+                )
+                clibschc.pystats_record_compress(clibschc.pystats_now_ns() - t_0)
+            if rule != NULL and device.promote_matched_rules:
+                _promote_rule(&device._dev, rule)
         if rule == NULL:
             if bit_arr.length == 0:
                 raise ValueError(
@@ -827,6 +1318,111 @@ cdef class CompressorDecompressor:
             return CompressionResult.UNCOMPRESSED, bit_arr
         return CompressionResult.COMPRESSED, bit_arr
 
+    @staticmethod
+    def compress_batch(
+        packets: typing.Sequence[typing.Union[bytes, bytearray, memoryview]],
+        device: Device,
+        dir: Direction,
+    ) -> typing.List[tuple]:
+        """Compress a batch of packets for ``device`` in ``dir``.
+
+        The batch is iterated over with the GIL released, so a burst of packets only
+        costs one Python call instead of one per packet.
+
+        :param packets: The packets to compress. Each may be any object implementing
+            the buffer protocol.
+        :type packets: :class:`typing.Sequence`
+        :param device: The device of which to use the compression context.
+        :type device: :class:`Device`
+        :param dir: The direction the packets are sent in.
+        :type dir: :class:`Direction`
+        :raise TypeError: When a packet does not implement the buffer protocol.
+        :raise ValueError: When direction is :attr:`pylibschc.libschc.Direction.BI`.
+        :raise ValueError: When a packet could not be compressed.
+        :raise MemoryError: If internal memory for the batch can not be allocated.
+        :return: For each packet, whether it was compressed or the uncompressed rule
+            was used and the compressed packet as a :class:`BitArray`, in the order of
+            ``packets``.
+        :rtype: :class:`typing.List` [ :class:`typing.Tuple` [
+            :class:`CompressionResult` ,
+            :class:`BitArray`
+            ] ]
+        """
+        cdef const uint8_t **ptrs = NULL
+        cdef uint16_t *lengths = NULL
+        cdef clibschc.schc_bitarray_t **outs = NULL
+        cdef clibschc.schc_compression_rule_t **rules = NULL
+        cdef const uint8_t[::1] buf
+        cdef BitArray bit_arr
+        cdef Py_ssize_t i
+        cdef Py_ssize_t n = len(packets)
+        cdef uint32_t device_id = device.device_id
+        cdef clibschc.direction c_dir
+        cdef bint promote = device.promote_matched_rules
+        cdef clibschc.schc_device *dev = &device._dev
+        cdef uint64_t t_0
+
+        if <clibschc.direction>dir.value == <clibschc.direction>Direction.BI.value:
+            raise ValueError("`dir` must be either UP or DOWN, not BI")
+        c_dir = <clibschc.direction>dir.value
+        uncomp_rule_id_bytes = clibschc.BITS_TO_BYTES(
+            device.uncompressed_rule_id_size_bits
+        )
+        ptrs = <const uint8_t **>malloc(n * sizeof(uint8_t *))
+        lengths = <uint16_t *>malloc(n * sizeof(uint16_t))
+        outs = <clibschc.schc_bitarray_t **>malloc(
+            n * sizeof(clibschc.schc_bitarray_t *)
+        )
+        rules = <clibschc.schc_compression_rule_t **>malloc(
+            n * sizeof(clibschc.schc_compression_rule_t *)
+        )
+        try:
+            if ptrs is NULL or lengths is NULL or outs is NULL or rules is NULL:
+                raise MemoryError("Unable to allocate batch")
+            views = []
+            bit_arrs = []
+            for i in range(n):
+                buf = packets[i]
+                views.append(buf)  # keep buffers acquired over the nogil loop
+                bit_arr = BitArray(buf.shape[0] + uncomp_rule_id_bytes)
+                bit_arrs.append(bit_arr)
+                if buf.shape[0] > 0:
+                    ptrs[i] = &buf[0]
+                else:
+                    ptrs[i] = NULL
+                lengths[i] = <uint16_t>buf.shape[0]
+                outs[i] = &bit_arr._bit_array
+            with device.lock:
+                with nogil:
+                    for i in range(n):
+                        t_0 = clibschc.pystats_now_ns()
+                        rules[i] = clibschc.schc_compress(
+                            <uint8_t *>ptrs[i], lengths[i], outs[i], device_id, c_dir
+                        )
+                        clibschc.pystats_record_compress(
+                            clibschc.pystats_now_ns() - t_0
+                        )
+                        if promote and rules[i] != NULL:
+                            _promote_rule(dev, rules[i])
+            res = []
+            for i in range(n):
+                bit_arr = bit_arrs[i]
+                if rules[i] == NULL:
+                    if bit_arr.length == 0:
+                        raise ValueError(
+                            f"Unable to compress packet {i} "
+                            f"(maybe wrong device #{device.device_id}?)"
+                        )
+                    res.append((CompressionResult.UNCOMPRESSED, bit_arr))
+                else:
+                    res.append((CompressionResult.COMPRESSED, bit_arr))
+            return res
+        finally:
+            free(<void *>ptrs)
+            free(<void *>lengths)
+            free(<void *>outs)
+            free(<void *>rules)
+
     @staticmethod
     def decompress(bit_arr: BitArray, device: Device, dir: Direction) -> bytes:
         """Decompress ``data`` for ``device`` in ``dir``.
@@ -841,18 +1437,92 @@ cdef class CompressorDecompressor:
         :return: The decompressed packet.
         :rtype: :class:`bytes`
         """
+        cdef uint16_t length
+        cdef uint16_t total_length = bit_arr._bit_array.len
+        cdef uint32_t device_id
+        cdef clibschc.direction c_dir
+        cdef uint8_t *decomp_buf = device._decomp_buf
+        cdef uint64_t t_0
+
         if <clibschc.direction>dir.value == <clibschc.direction>Direction.BI.value:
             raise ValueError("`dir` must be either UP or DOWN, not BI")
 
-        buf = b"\0" * clibschc.MAX_MTU_LENGTH
-        cdef uint16_t length = clibschc.schc_decompress(
-            &bit_arr._bit_array,
-            <uint8_t *>(<char *>buf),
-            device.device_id,
-            bit_arr.length,
-            <clibschc.direction>dir.value
-        )
-        return buf[:length]
+        device_id = <uint32_t>device.device_id
+        c_dir = <clibschc.direction>dir.value
+        with device.lock:
+            with nogil:
+                t_0 = clibschc.pystats_now_ns()
+                length = clibschc.schc_decompress(
+                    &bit_arr._bit_array,
+                    decomp_buf,
+                    device_id,
+                    total_length,
+                    c_dir
+                )
+                clibschc.pystats_record_decompress(
+                    clibschc.pystats_now_ns() - t_0
+                )
+            return <bytes>decomp_buf[:length]
+
+    @staticmethod
+    def decompress_into(
+        bit_arr: BitArray,
+        out: typing.Union[bytearray, memoryview],
+        device: Device,
+        dir: Direction,
+    ) -> int:
+        """Decompress ``bit_arr`` for ``device`` in ``dir`` into a caller-provided
+        buffer.
+
+        In contrast to :meth:`CompressorDecompressor.decompress` this performs no heap
+        allocation, so ``out`` can come from a pool of reusable buffers.
+
+        :param bit_arr: The data to decompress.
+        :type bit_arr: :class:`BitArray`
+        :param out: A writable buffer the decompressed packet is written to. Must be at
+            least :data:`MAX_MTU_LENGTH` bytes long, as the decompressed packet may
+            grow up to that size.
+        :type out: :class:`typing.Union[bytearray, memoryview]`
+        :param device: The device of which to use the compression context.
+        :type device: :class:`Device`
+        :param dir: The direction ``data`` is sent in.
+        :type dir: :class:`Direction`
+        :raise TypeError: When ``out`` does not implement the writable buffer protocol.
+        :raise ValueError: When direction is :attr:`pylibschc.libschc.Direction.BI`.
+        :raise ValueError: When ``out`` is smaller than :data:`MAX_MTU_LENGTH` bytes.
+        :return: The length of the decompressed packet within ``out``.
+        :rtype: :class:`int`
+        """
+        cdef uint8_t[::1] buf = out
+        cdef uint16_t length
+        cdef uint16_t total_length = bit_arr._bit_array.len
+        cdef uint32_t device_id
+        cdef clibschc.direction c_dir
+        cdef uint64_t t_0
+
+        if <clibschc.direction>dir.value == <clibschc.direction>Direction.BI.value:
+            raise ValueError("`dir` must be either UP or DOWN, not BI")
+        if buf.shape[0] < <Py_ssize_t>clibschc.MAX_MTU_LENGTH:
+            raise ValueError(
+                f"`out` (size {buf.shape[0]}) must be at least MAX_MTU_LENGTH "
+                f"({clibschc.MAX_MTU_LENGTH}) bytes long"
+            )
+        device_id = <uint32_t>device.device_id
+        c_dir = <clibschc.direction>dir.value
+        with device.lock:
+            with nogil:
+                t_0 = clibschc.pystats_now_ns()
+                length = clibschc.schc_decompress(
+                    &bit_arr._bit_array,
+                    &buf[0],
+                    device_id,
+                    total_length,
+                    c_dir
+                )
+                clibschc.pystats_record_decompress(
+                    clibschc.pystats_now_ns() - t_0
+                )
+        return length
 
 
 class TXState(enum.Enum):
@@ -976,6 +1646,37 @@ cdef class _TimerTask:
             )
 
 
+# free lists to recycle fragmentation connections and their wrapper objects, so
+# steady-state reassembly does not allocate; guarded by _conn_pool_lock
+cdef int _CONN_POOL_MAX = 512
+cdef list _conn_struct_pool = []
+cdef list _conn_obj_pool = []
+_conn_pool_lock = threading.Lock()
+
+
+cdef clibschc.schc_fragmentation_t *_conn_struct_get():
+    with _conn_pool_lock:
+        if _conn_struct_pool:
+            return <clibschc.schc_fragmentation_t *>(
+                <void *><intptr_t>_conn_struct_pool.pop()
+            )
+    return <clibschc.schc_fragmentation_t *>malloc(
+        sizeof(clibschc.schc_fragmentation_t)
+    )
+
+
+cdef void _conn_struct_put(clibschc.schc_fragmentation_t *conn):
+    # module globals may already be gone on interpreter teardown
+    if _conn_pool_lock is None or _conn_struct_pool is None:
+        free(conn)
+        return
+    with _conn_pool_lock:
+        if len(_conn_struct_pool) < _CONN_POOL_MAX:
+            _conn_struct_pool.append(<intptr_t><void *>conn)
+            return
+    free(conn)
+
+
 cdef class FragmentationConnection:
     """
     A fragmentation connection. Wraps the ``schc_fragmentation_t`` type of libSCHC.
@@ -988,6 +1689,9 @@ cdef class FragmentationConnection:
     cdef clibschc.schc_fragmentation_t *_frag_conn
     cdef uint8_t _fragmented
     cdef uint8_t _malloced
+    cdef bint _paced
+    cdef object _paced_pending
+    cdef object _paced_event
     _device_sends = {}
 
     def __cinit__(
@@ -998,12 +1702,13 @@ cdef class FragmentationConnection:
         self.ops = ops
         self._fragmented = False
         self._bit_arr = None
+        self._paced = False
+        self._paced_pending = None
+        self._paced_event = threading.Event()
         self._malloced = _malloc_inner
         if _malloc_inner:
             try:
-                self._frag_conn = <clibschc.schc_fragmentation_t *>malloc(
-                    sizeof(clibschc.schc_fragmentation_t)
-                )
+                self._frag_conn = _conn_struct_get()
                 if not self._frag_conn:
                     raise MemoryError(
                         "Unable to allocate inner fragmentation connection"
@@ -1018,7 +1723,7 @@ cdef class FragmentationConnection:
 
     cdef _init_ops(self):
         self._frag_conn.timer_ctx = <void *>self
-        self._frag_conn.send = self._send
+        self._frag_conn.send = clibschc.schc_send_dispatch
         self._frag_conn.post_timer_task = self._c_post_timer_task
         self._frag_conn.end_rx = self._c_end_rx
         self._frag_conn.end_tx = self._c_end_tx
@@ -1028,7 +1733,7 @@ cdef class FragmentationConnection:
     def __dealloc__(self):
         if self._frag_conn and self._malloced:
             self._frag_conn.timer_ctx = NULL
-            free(self._frag_conn)
+            _conn_struct_put(self._frag_conn)
             self._malloced = False
             self._frag_conn = NULL
 
@@ -1115,6 +1820,88 @@ cdef class FragmentationConnection:
         clibschc.mbuf_copy(conn, <uint8_t *>(<char *>buf))
         return buf
 
+    def mbuf_copy_into(self, out: typing.Union[bytearray, memoryview]) -> int:
+        """Copy the reassembly buffer of the fragmentation connection into a
+        caller-provided buffer.
+
+        In contrast to :attr:`FragmentationConnection.mbuf` this performs no heap
+        allocation, so ``out`` can come from a pool of reusable buffers.
+
+        :param out: A writable buffer the reassembled packet is written to.
+        :type out: :class:`typing.Union[bytearray, memoryview]`
+        :raise TypeError: When ``out`` does not implement the writable buffer protocol.
+        :raise ValueError: When ``out`` is too small for the reassembled packet.
+        :return: The length of the reassembled packet within ``out``.
+        :rtype: :class:`int`
+        """
+        cdef uint8_t[::1] buf = out
+        cdef size_t size
+
+        assert self._frag_conn, "FragmentationConnection not properly initialized"
+        size = clibschc.get_mbuf_len(self._frag_conn)
+        if <size_t>buf.shape[0] < size:
+            raise ValueError(
+                f"`out` (size {buf.shape[0]}) is too small for reassembled packet "
+                f"({size} bytes)"
+            )
+        if size > 0:
+            clibschc.mbuf_copy(self._frag_conn, &buf[0])
+        return size
+
+    def reassemble_and_decompress(self, device: Device, dir: Direction) -> bytes:
+        """Decompress the reassembled packet of this connection for ``device`` in
+        ``dir``.
+
+        The mbuf chain is flattened into a C-level scratch buffer that is handed to
+        ``schc_decompress()`` directly, so no intermediate :class:`bytes` object or
+        :class:`BitArray` is materialized between reassembly and decompression.
+
+        :param device: The device of which to use the compression context.
+        :type device: :class:`Device`
+        :param dir: The direction the packet was sent in.
+        :type dir: :class:`Direction`
+        :raise ValueError: When direction is :attr:`pylibschc.libschc.Direction.BI`.
+        :return: The decompressed packet.
+        :rtype: :class:`bytes`
+        """
+        cdef clibschc.schc_bitarray_t bit_arr
+        cdef uint8_t *mbuf_buf
+        cdef uint8_t *decomp_buf
+        cdef uint16_t length
+        cdef size_t size
+        cdef uint32_t device_id
+        cdef clibschc.direction c_dir
+        cdef uint64_t t_0
+
+        assert self._frag_conn, "FragmentationConnection not properly initialized"
+        if <clibschc.direction>dir.value == <clibschc.direction>Direction.BI.value:
+            raise ValueError("`dir` must be either UP or DOWN, not BI")
+        size = clibschc.get_mbuf_len(self._frag_conn)
+        mbuf_buf = <uint8_t *>malloc(size or 1)
+        if not mbuf_buf:
+            raise MemoryError("Unable to allocate reassembly buffer")
+        try:
+            clibschc.mbuf_copy(self._frag_conn, mbuf_buf)
+            memset(&bit_arr, 0, sizeof(bit_arr))
+            bit_arr.ptr = mbuf_buf
+            bit_arr.len = <uint16_t>size
+            bit_arr.bit_len = <uint32_t>size * 8
+            device_id = <uint32_t>device.device_id
+            c_dir = <clibschc.direction>dir.value
+            decomp_buf = device._decomp_buf
+            with device.lock:
+                with nogil:
+                    t_0 = clibschc.pystats_now_ns()
+                    length = clibschc.schc_decompress(
+                        &bit_arr, decomp_buf, device_id, <uint16_t>size, c_dir
+                    )
+                    clibschc.pystats_record_decompress(
+                        clibschc.pystats_now_ns() - t_0
+                    )
+                return <bytes>decomp_buf[:length]
+        finally:
+            free(mbuf_buf)
+
     cdef int _allocated(self):
         return (<void *>self._frag_conn) is not NULL
 
@@ -1136,19 +1923,14 @@ cdef class FragmentationConnection:
         return None
 
     @staticmethod
-    cdef uint8_t _send(uint8_t *data, uint16_t length, uint32_t device_id):
-        if device_id in FragmentationConnection._device_sends:
-            try:
-                return <uint8_t>FragmentationConnection._device_sends[
-                    device_id
-                ](<bytes>data[:length])
-            except Exception:
-                raise
-        else:
-            raise ProcessLookupError(f"No send registered for device #{device_id}")
+    cdef bint _send_registered(uint32_t device_id):
+        return (
+            device_id in FragmentationConnection._device_sends
+            or bool(clibschc.schc_send_is_registered(device_id))
+        )
 
     @staticmethod
-    cdef void _c_end_rx(clibschc.schc_fragmentation_t *conn):
+    cdef void _c_end_rx(clibschc.schc_fragmentation_t *conn) with gil:
         try:
             obj = FragmentationConnection._outer_from_struct(conn)
             if obj and obj.ops and obj.ops.end_rx:
@@ -1157,8 +1939,10 @@ cdef class FragmentationConnection:
             raise
 
     @staticmethod
-    cdef void _c_end_tx(clibschc.schc_fragmentation_t *conn):
+    cdef void _c_end_tx(clibschc.schc_fragmentation_t *conn) with gil:
         try:
+            # a batched send backend still stages the tail of the transfer
+            clibschc.schc_send_flush(conn.device_id)
             obj = FragmentationConnection._outer_from_struct(conn)
             if obj and obj.ops and obj.ops.end_tx:
                 obj.ops.end_tx(obj)
@@ -1166,9 +1950,13 @@ cdef class FragmentationConnection:
             raise
 
     @staticmethod
-    cdef void _c_remove_timer_entry(clibschc.schc_fragmentation_t *conn):
+    cdef void _c_remove_timer_entry(clibschc.schc_fragmentation_t *conn) with gil:
         try:
             obj = FragmentationConnection._outer_from_struct(conn)
+            if obj and obj._paced:
+                obj._paced_pending = None
+                obj._paced_event.set()
+                return
             if obj and obj.ops and obj.ops.remove_timer_entry:
                 obj.ops.remove_timer_entry(obj)
         except Exception:
@@ -1180,8 +1968,16 @@ cdef class FragmentationConnection:
         void (*timer_task)(void *arg),
         uint32_t time_ms,
         void *arg
-    ):
+    ) with gil:
         obj = FragmentationConnection._outer_from_struct(conn)
+        if obj is not None and obj._paced:
+            obj._paced_pending = (
+                <intptr_t>(<void *>timer_task),
+                <intptr_t>arg,
+                time.monotonic() + time_ms / 1000,
+            )
+            obj._paced_event.set()
+            return
         if obj and obj.ops and obj.ops.post_timer_task:
             task = _TimerTask(obj, <intptr_t>(<void *>timer_task), <intptr_t>arg)
             obj.ops.post_timer_task(
@@ -1196,7 +1992,7 @@ cdef class FragmentationConnection:
             self._frag_conn = NULL
 
     @staticmethod
-    cdef void _c_free_conn_cb(clibschc.schc_fragmentation_t *conn):
+    cdef void _c_free_conn_cb(clibschc.schc_fragmentation_t *conn) with gil:
         try:
             obj = FragmentationConnection._outer_from_struct(conn)
             if obj:
@@ -1227,6 +2023,78 @@ cdef class FragmentationConnection:
         """
         del FragmentationConnection._device_sends[device_id]
 
+    @staticmethod
+    def register_send_socket(device_id: int, fileno: int):
+        """Register a connected datagram socket as C-level send fast path for a
+        device.
+
+        Fragments for ``device_id`` are then written to ``fileno`` with ``send(2)``
+        directly from ``schc_fragment()``, without entering Python or allocating.
+        Takes precedence over a callable registered with
+        :py:meth:`FragmentationConnection.register_send`, which remains as fallback
+        for devices without a socket.
+
+        :param device_id: The identifier for the device.
+        :type device_id: int
+        :param fileno: The file descriptor of a connected datagram socket.
+        :type fileno: int
+        :raise MemoryError: If memory for the send registry can not be allocated.
+        """
+        if clibschc.schc_send_register_udp(<uint32_t>device_id, <int>fileno) < 0:
+            raise MemoryError("Unable to allocate send registry entry")
+
+    @staticmethod
+    def unregister_send_socket(device_id: int):
+        """Remove the C-level send fast path for a device.
+
+        :param device_id: The identifier for the device.
+        :type device_id: int
+        """
+        clibschc.schc_send_unregister(<uint32_t>device_id)
+
+    @staticmethod
+    def register_send_mmsg(device_id: int, fileno: int):
+        """Register a connected datagram socket as batched scatter-gather send
+        backend for a device.
+
+        Fragments for ``device_id`` are staged in C into a batch of up to
+        :py:data:`SCHC_SEND_MMSG_BATCH` buffers and reach ``fileno`` with one
+        ``sendmmsg(2)`` call per batch — when the batch is full, when a
+        transmission ends or on
+        :py:meth:`FragmentationConnection.flush_send` — instead of one
+        :py:class:`bytes` allocation and one syscall per fragment. Takes
+        precedence over a callable registered with
+        :py:meth:`FragmentationConnection.register_send`. Remove with
+        :py:meth:`FragmentationConnection.unregister_send_socket`.
+
+        :param device_id: The identifier for the device.
+        :type device_id: int
+        :param fileno: The file descriptor of a connected datagram socket.
+        :type fileno: int
+        :raise MemoryError: If memory for the send backend can not be allocated.
+        """
+        if clibschc.schc_send_register_mmsg(<uint32_t>device_id, <int>fileno) < 0:
+            raise MemoryError("Unable to allocate send backend")
+
+    @staticmethod
+    def flush_send(device_id: int) -> int:
+        """Send out any fragments staged by the batched send backend of a
+        device.
+
+        No-op for devices without a backend registered with
+        :py:meth:`FragmentationConnection.register_send_mmsg`.
+
+        :param device_id: The identifier for the device.
+        :type device_id: int
+        :raise OSError: If sending failed.
+        :return: The number of fragments flushed.
+        :rtype: int
+        """
+        res = clibschc.schc_send_flush(<uint32_t>device_id)
+        if res < 0:
+            raise OSError("Unable to flush batched send backend")
+        return res
+
     def init_rx(
         self,
         device_id: uint32_t,
@@ -1241,7 +2109,7 @@ cdef class FragmentationConnection:
         :type ds: int
         """
         assert self._frag_conn, "FragmentationConnection not properly initialized"
-        assert device_id in FragmentationConnection._device_sends, (
+        assert FragmentationConnection._send_registered(device_id), (
             f"No send registered for device #{device_id}"
         )
         assert self.ops.end_rx is not None
@@ -1272,7 +2140,7 @@ cdef class FragmentationConnection:
         :type mode: :py:class:`FragmentationMode`
         """
         assert self._frag_conn, "FragmentationConnection not properly initialized"
-        assert device_id in FragmentationConnection._device_sends, (
+        assert FragmentationConnection._send_registered(device_id), (
             f"No send registered for device #{device_id}"
         )
         assert self.ops.remove_timer_entry is not None
@@ -1319,10 +2187,184 @@ cdef class FragmentationConnection:
         """
         return FragmentationResult(self._fragment())
 
+    def fragment_paced(self) -> FragmentationResult:
+        """Send :py:attr:`FragmentationConnection.bit_arr`, if necessary fragmented,
+        driving the complete transmission from the calling thread.
+
+        Duty-cycle pacing between fragments happens by waiting in the calling thread
+        instead of posting one timer task per fragment to
+        :py:attr:`FragmenterOps.post_timer_task`; only ``end_tx`` and errors surface
+        to Python. The call blocks until the transmission has completed, including
+        any ACK exchanges — ACKs may be fed in concurrently via
+        :py:meth:`FragmentationConnection.input`.
+
+        :raises MemoryError: see :py:meth:`FragmentationConnection.fragment`.
+        :retval NO_FRAGMENTATION: If the packet was not fragmented.
+        :retval SUCCESS: If the packet was fragmented.
+        :rtype: :py:class:`FragmentationResult`
+        """
+        cdef int8_t res
+
+        self._paced = True
+        self._paced_pending = None
+        try:
+            res = self._fragment()
+            while True:
+                self._paced_event.clear()
+                pending = self._paced_pending
+                if pending is None:
+                    break
+                timeout = pending[2] - time.monotonic()
+                if timeout > 0 and self._paced_event.wait(timeout):
+                    # the timer task was replaced or canceled in the meantime
+                    continue
+                if self._paced_pending is not pending:
+                    continue
+                self._paced_pending = None
+                _TimerTask.call_the_task(
+                    <void (*)(void *)>(<void *><intptr_t>pending[0]),
+                    <void *><intptr_t>pending[1]
+                )
+            return FragmentationResult(res)
+        finally:
+            self._paced = False
+            self._paced_pending = None
+
+    def send_packet(
+        self,
+        data,
+        device: Device,
+        dir: Direction,
+        mtu: uint16_t,
+        dc: uint32_t,
+        mode: clibschc.reliability_mode,
+        bit_arr: BitArray = None,
+    ) -> tuple:
+        """Compress ``data`` and transmit it, fragmented if necessary, in one call.
+
+        Fuses :py:meth:`CompressorDecompressor.compress`,
+        :py:meth:`FragmentationConnection.init_tx`, and
+        :py:meth:`FragmentationConnection.fragment`: ``schc_compress()`` writes into
+        the ``schc_bitarray_t`` the connection then fragments from, so no
+        intermediate buffer copy and no Python round-trip happens between the two
+        stages.
+
+        :param data: The packet to compress and send. May be any object implementing
+            the buffer protocol.
+        :param device: The device of which to use the compression context.
+        :type device: :class:`Device`
+        :param dir: The direction ``data`` is sent in.
+        :type dir: :class:`Direction`
+        :param mtu: The link layer MTU for this connection in bytes.
+        :type mtu: :class:`int`
+        :param dc: Duty cycle in milliseconds for the connection.
+        :type dc: :class:`int`
+        :param mode: The fragmentation mode for this connection.
+        :type mode: :py:class:`FragmentationMode`
+        :param bit_arr: A :class:`BitArray` to re-use for the compression result. If
+            None, a new :class:`BitArray` is allocated; otherwise it is grown as
+            needed with :py:meth:`BitArray.reserve`.
+        :type bit_arr: :class:`BitArray`
+        :raise TypeError: When ``data`` does not implement the buffer protocol.
+        :raise ValueError: When direction is :attr:`pylibschc.libschc.Direction.BI`.
+        :raise ValueError: When ``data`` can not be compressed for ``device`` or no
+            fragmentation rule for ``mode`` can be found.
+        :raises MemoryError: see :py:meth:`FragmentationConnection.fragment`.
+        :return: Whether the packet was compressed and whether it was fragmented.
+        :rtype: :class:`typing.Tuple` [
+            :class:`CompressionResult` ,
+            :class:`FragmentationResult`
+            ]
+        """
+        cdef clibschc.schc_compression_rule_t *rule
+        cdef const uint8_t[::1] buf = data
+        cdef const uint8_t *ptr = NULL
+        cdef uint16_t length = <uint16_t>buf.shape[0]
+        cdef uint32_t device_id
+        cdef clibschc.direction c_dir
+        cdef uint64_t t_0
+
+        if <clibschc.direction>dir.value == <clibschc.direction>Direction.BI.value:
+            raise ValueError("`dir` must be either UP or DOWN, not BI")
+        assert self._frag_conn, "FragmentationConnection not properly initialized"
+        device_id = <uint32_t>device.device_id
+        assert FragmentationConnection._send_registered(device_id), (
+            f"No send registered for device #{device_id}"
+        )
+        assert self.ops.remove_timer_entry is not None
+        # need at minimum length + rule length
+        size = length + clibschc.BITS_TO_BYTES(device.uncompressed_rule_id_size_bits)
+        if bit_arr is None:
+            bit_arr = BitArray(size)
+        else:
+            bit_arr._check_writable()
+            bit_arr._reserve(size)
+            # restore the state of a freshly allocated BitArray of that size
+            memset(<void *>bit_arr._bit_array.ptr, 0, bit_arr._capacity)
+            bit_arr._bit_array.offset = 0
+            bit_arr._bit_array.padding = 0
+            bit_arr._bit_array.len = size
+            bit_arr._bit_array.bit_len = 0
+            if <size_t>size > bit_arr.size:
+                bit_arr.size = size
+        # initialize the connection for transmission up front, so fragmentation can
+        # start right on the compression result
+        if clibschc.schc_fragmenter_init(self._frag_conn) != 1:
+            raise MemoryError("Unable to initialize FragmentationConnection")
+        self._init_ops()
+        self._frag_conn.fragmentation_rule = (
+            clibschc.get_fragmentation_rule_by_reliability_mode(mode, device_id)
+        )
+        if self._frag_conn.fragmentation_rule is NULL:
+            raise ValueError(
+                "Unable to find fragmentation rule for mode "
+                f"{FragmentationMode(mode)} on device #{device_id}"
+            )
+        self._frag_conn.device_id = device_id
+        self.bit_arr = bit_arr
+        self._frag_conn.mtu = mtu
+        self._frag_conn.dc = dc
+        if length > 0:
+            ptr = &buf[0]
+        c_dir = <clibschc.direction>dir.value
+        with device.lock:
+            with nogil:
+                t_0 = clibschc.pystats_now_ns()
+                rule = clibschc.schc_compress(
+                    <uint8_t *>ptr,
+                    length,
+                    &bit_arr._bit_array,
+                    device_id,
+                    c_dir
+                )
+                clibschc.pystats_record_compress(clibschc.pystats_now_ns() - t_0)
+            if rule != NULL and device.promote_matched_rules:
+                _promote_rule(&device._dev, rule)
+        if rule == NULL:
+            if bit_arr.length == 0:
+                raise ValueError(
+                    f"Unable to compress (maybe wrong device #{device.device_id}?)"
+                )
+            comp_res = CompressionResult.UNCOMPRESSED
+        else:
+            comp_res = CompressionResult.COMPRESSED
+        return comp_res, FragmentationResult(self._fragment())
+
     cdef FragmentationConnection _new_conn(self, clibschc.schc_fragmentation_t *conn):
-        res = FragmentationConnection._outer_from_struct(conn)
+        cdef FragmentationConnection res = (
+            FragmentationConnection._outer_from_struct(conn)
+        )
         if res is None:
-            res = FragmentationConnection(ops=self.ops, _malloc_inner=False)
+            with _conn_pool_lock:
+                if _conn_obj_pool:
+                    res = <FragmentationConnection>_conn_obj_pool.pop()
+            if res is None:
+                res = FragmentationConnection(ops=self.ops, _malloc_inner=False)
+            else:  # restore the state of a freshly constructed wrapper
+                res.ops = self.ops
+                res._fragmented = False
+                res._bit_arr = None
+                res._malloced = False
             conn.dc = self._frag_conn.dc
             FragmentationConnection._set_frag_conn(res, conn)
         return res
@@ -1346,6 +2388,7 @@ cdef class FragmentationConnection:
                     <intptr_t>self._frag_conn
                 )
                 return None
+            clibschc.pystats_count_input()
             conn_ptr = clibschc.schc_input(
                 <uint8_t *>buf, length, self._frag_conn, self._frag_conn.device_id
             )
@@ -1393,6 +2436,138 @@ cdef class FragmentationConnection:
         except Exception:
             raise
 
+    cdef tuple _batch_not_fragmented(
+        self, Py_ssize_t i, clibschc.schc_fragmentation_t *conn
+    ):
+        cdef FragmentationConnection wrapper = self._new_conn(conn)
+        wrapper._fragmented = 0
+        payload = wrapper._get_mbuf()
+        if self.ops and self.ops.end_rx:
+            self.ops.end_rx(wrapper)
+        wrapper.reset()
+        return (i, ReassemblyStatus.COMPLETED, payload)
+
+    cdef tuple _batch_reassembled(
+        self, Py_ssize_t i, clibschc.schc_fragmentation_t *conn, int8_t res
+    ):
+        cdef FragmentationConnection wrapper = self._new_conn(conn)
+        wrapper._fragmented = 1
+        payload = None
+        if res > 0:
+            payload = wrapper._get_mbuf()
+        if (  # last fragment received with NO_ACK, see _reassemble()
+            res
+            and conn.fragmentation_rule != NULL
+            and conn.fragmentation_rule.mode == clibschc.NO_ACK
+        ):
+            if self.ops and self.ops.end_rx:
+                self.ops.end_rx(wrapper)
+            wrapper.reset()
+        return (i, ReassemblyStatus(res), payload)
+
+    def input_batch(self, datagrams: typing.Sequence) -> list:
+        """Handle a batch of received datagrams in one call.
+
+        The batch is fed to ``schc_input()``/``schc_reassemble()`` with the GIL
+        released; Python is only re-entered for events worth reporting, so a burst
+        of in-sequence fragments (e.g. from one ``recvmmsg()`` call) costs no
+        per-datagram Python round-trip.
+
+        :param datagrams: The received datagrams, each either an ACK, a fragment,
+            or an unfragmented packet.
+        :type datagrams: :py:class:`typing.Sequence` [ :py:class:`bytes` or
+            :py:class:`BitArray` ]
+        :raises MemoryError: If a new connection object or one of its members could
+            not be allocated.
+        :return: One ``(index, status, packet)`` tuple per completed packet or
+            state change, in datagram order: ``index`` is the position within
+            ``datagrams``, ``status`` a :py:class:`ReassemblyStatus`, and
+            ``packet`` the reassembled packet as :py:class:`bytes` for completed
+            receptions (None otherwise). Datagrams that only continued an ongoing
+            reassembly produce no entry.
+        """
+        cdef clibschc.schc_fragmentation_t *listener = self._frag_conn
+        cdef clibschc.schc_fragmentation_t *conn_ptr
+        cdef const uint8_t **ptrs = NULL
+        cdef uint16_t *lengths = NULL
+        cdef Py_ssize_t n = len(datagrams)
+        cdef Py_ssize_t i
+        cdef uint32_t device_id
+        cdef uint32_t dc
+        cdef int8_t res
+
+        assert self._frag_conn, "FragmentationConnection not properly initialized"
+        if n == 0:
+            return []
+        if not listener.device_id:
+            logger.info(
+                "%s (0x%x) has no device_id. This may happen if last ACK was "
+                "received as a duplicate.",
+                self,
+                <intptr_t>self._frag_conn
+            )
+            return []
+        device_id = listener.device_id
+        dc = listener.dc
+        events = []
+        ptrs = <const uint8_t **>malloc(n * sizeof(uint8_t *))
+        lengths = <uint16_t *>malloc(n * sizeof(uint16_t))
+        if not ptrs or not lengths:
+            free(<void *>ptrs)
+            free(<void *>lengths)
+            raise MemoryError("Unable to allocate input batch")
+        try:
+            for i in range(n):
+                data = datagrams[i]
+                if isinstance(data, BitArray):
+                    ptrs[i] = <const uint8_t *>_bit_array_ptr(<BitArray>data)
+                    lengths[i] = <uint16_t>(<BitArray>data).length
+                else:
+                    ptrs[i] = <const uint8_t *><char *>data
+                    lengths[i] = <uint16_t>len(data)
+            with nogil:
+                for i in range(n):
+                    # re-arm the listening connection, as e.g. a completed
+                    # reception resets it (see init_rx())
+                    listener.device_id = device_id
+                    listener.dc = dc
+                    clibschc.pystats_count_input()
+                    conn_ptr = clibschc.schc_input(
+                        <uint8_t *>ptrs[i], lengths[i], listener, device_id
+                    )
+                    if conn_ptr == NULL:
+                        with gil:
+                            raise MemoryError(
+                                f"Unable to allocate a RX connection for "
+                                f"datagram {i}"
+                            )
+                    if conn_ptr == listener:  # datagram was an ACK
+                        with gil:
+                            self._fragmented = 0
+                            events.append((i, ReassemblyStatus.ACK_HANDLED, None))
+                        continue
+                    if not conn_ptr.timer_ctx:
+                        # first fragment of a new transfer: wrap the connection so
+                        # its C callbacks are in place before schc_reassemble()
+                        with gil:
+                            self._new_conn(conn_ptr)
+                    if (
+                        not conn_ptr.fragmentation_rule
+                        or conn_ptr.fragmentation_rule.mode == clibschc.NOT_FRAGMENTED
+                    ):
+                        with gil:
+                            events.append(self._batch_not_fragmented(i, conn_ptr))
+                        continue
+                    res = clibschc.schc_reassemble(conn_ptr)
+                    if res == <int8_t>0:  # ONGOING: stay in C
+                        continue
+                    with gil:
+                        events.append(self._batch_reassembled(i, conn_ptr, res))
+        finally:
+            free(<void *>ptrs)
+            free(<void *>lengths)
+        return events
+
     cdef int8_t _reassemble(self):
         try:
             assert self._frag_conn, "FragmentationConnection not properly initialized"
@@ -1430,26 +2605,108 @@ cdef class FragmentationConnection:
 
         .. warning::
             After this method was called, a connection created by
-            :py:meth:`FragmentationConnection.input()` should not be used and is
-            recommended to be deleted after."""
+            :py:meth:`FragmentationConnection.input()` must not be used anymore, as
+            its wrapper object may be recycled for a later connection."""
         if self._frag_conn:
             clibschc.schc_reset(self._frag_conn)
             if self._malloced:
                 self._frag_conn.timer_ctx = <void *>self
-            else:  # was allocated by libschc => discard
+                # release the payload, e.g. so a borrowed buffer can be closed
+                self._bit_arr = None
+                self._frag_conn.bit_arr = NULL
+            else:  # was allocated by libschc => recycle wrapper
                 self._frag_conn = NULL
+                self._recycle()
+
+    cdef _recycle(self):
+        self.ops = None
+        self._bit_arr = None
+        self._fragmented = False
+        self._paced = False
+        self._paced_pending = None
+        with _conn_pool_lock:
+            if len(_conn_obj_pool) < _CONN_POOL_MAX:
+                _conn_obj_pool.append(self)
 
 
 PYLOG_BUFFER_SIZE = clibschc.PYLOG_BUFFER_SIZE
 
 
-cdef public int pylog_in_debug():
+cdef public uint8_t pysend_call(
+    uint8_t *data, uint16_t length, uint32_t device_id
+) with gil:
+    # Python-callable fallback of schc_send_dispatch() in src/send_registry.c
+    if device_id in FragmentationConnection._device_sends:
+        return <uint8_t>FragmentationConnection._device_sends[
+            device_id
+        ](<bytes>data[:length])
+    raise ProcessLookupError(f"No send registered for device #{device_id}")
+
+
+cdef public int pylog_in_debug() with gil:
     return (<long>logger.getEffectiveLevel()) <= (<long>logging.DEBUG)
 
 
-cdef public void pylog_call_debug(char *string):
+cdef public void pylog_call_debug(char *string) with gil:
     logger.debug((<bytes>string).decode())
 
 
+def _pylog_drain_loop():  # pragma: no cover
+    while True:
+        clibschc.pylog_flush()
+        time.sleep(.05)
+
+
+cdef public void pylog_start_drainer() with gil:
+    # Called from src/pylogging.c on the first log record emitted by a thread
+    # that does not hold the GIL
+    threading.Thread(
+        target=_pylog_drain_loop, name="pylibschc-log-drainer", daemon=True
+    ).start()
+
+
+def pylog_flush() -> int:
+    """Forward any buffered log records to the :py:mod:`logging` module.
+
+    :return: The number of records forwarded.
+    :rtype: :class:`int`"""
+    return clibschc.pylog_flush()
+
+
+def stats_enabled() -> bool:
+    """Whether the hot-path statistics counters are compiled in.
+
+    :retval False: When the module was built with ``NSTATS=1``."""
+    return bool(clibschc.pystats_enabled())
+
+
+def stats_snapshot() -> dict:
+    """Aggregate the hot-path statistics counters of all threads.
+
+    See :mod:`pylibschc.stats` for a more pythonic interface.
+
+    :return: The counters declared in ``pystats.h``, with the latency histograms as
+        lists of per-bucket counts (bucket ``i`` counts calls that took
+        ``2^i <= d < 2^(i+1)`` nanoseconds).
+    :rtype: :class:`dict`"""
+    cdef clibschc.pystats_counters_t counters
+    cdef int i
+
+    clibschc.pystats_snapshot(&counters)
+    return {
+        "compress_calls": counters.compress_calls,
+        "compress_ns": [
+            counters.compress_ns[i] for i in range(clibschc.PYSTATS_NS_BUCKETS)
+        ],
+        "decompress_calls": counters.decompress_calls,
+        "decompress_ns": [
+            counters.decompress_ns[i] for i in range(clibschc.PYSTATS_NS_BUCKETS)
+        ],
+        "input_calls": counters.input_calls,
+        "fragments_sent": counters.fragments_sent,
+        "fragment_bytes": counters.fragment_bytes,
+    }
+
+
 def test_pylog_debug(fmt: bytes, str_arg: bytes, int_arg: int):
     clibschc.pylog_debug(fmt, <char *>str_arg, <int>int_arg)
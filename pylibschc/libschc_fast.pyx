@@ -0,0 +1,14 @@
+# Copyright (C) 2023 Freie Universität Berlin
+#
+# SPDX-License-Identifier: GPL-3.0-only
+
+"""Compile-time specialized build variant of :mod:`pylibschc.libschc`.
+
+Shares all code with :mod:`pylibschc.libschc`, but is compiled with
+``NLOGGING=1`` (and possibly reduced ``MAX_FIELD_LENGTH``/``MAX_MTU_LENGTH``,
+see ``setup.py``), stripping all ``DEBUG_PRINTF()`` calls from the libSCHC hot
+path. Only built when ``PYLIBSCHC_BUILD_FAST`` is set during installation;
+select it at import by setting ``PYLIBSCHC_VARIANT=fast`` in the
+environment."""
+
+include "libschc.pyx"
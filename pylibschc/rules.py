@@ -5,6 +5,7 @@
 """Representation and configuration of rules."""
 
 import argparse
+import hashlib
 import ipaddress
 import struct
 import typing
@@ -615,6 +616,14 @@ class Config(BaseModel):
             devices.append(device)
         return argparse.Namespace(devices=devices)
 
+    def compile(self) -> "CompiledConfig":
+        """Lower this rule configuration to its C-ready form, validated only once.
+
+        :return: The compiled configuration, cached by content hash, so compiling an
+            unchanged configuration again returns the same object.
+        :rtype: :class:`CompiledConfig`"""
+        return CompiledConfig.compile(self)
+
     def to_c_header(self) -> str:  # noqa: C901
         # pylint: disable=too-many-locals,too-many-branches,too-many-statements
         """Provides the C header file for this rules configuration as a string.
@@ -849,3 +858,95 @@ extern "C" {
 #endif /* RULES_RULE_CONFIG_H */
 """
         return res
+
+
+class CompiledConfig:
+    """A :class:`Config` lowered once to the representation consumed by libSCHC.
+
+    Pydantic validation and model traversal only happen when the configuration is
+    compiled; :meth:`CompiledConfig.deploy` pushes the pre-lowered rules without
+    re-validating, and re-deploying an unchanged configuration onto a device that
+    already runs it is a no-op.
+
+    :param config: The rule configuration to lower.
+    :type config: :class:`Config`
+    """
+
+    _cache: typing.Dict[str, "CompiledConfig"] = {}
+
+    def __init__(self, config: Config):
+        self.content_hash = self._content_hash(config)
+        """Hash over the serialized configuration, identifying its content."""
+        self._devices = [
+            {
+                "device_id": device.device_id,
+                "mtu": device.mtu,
+                "duty_cycle_ms": device.duty_cycle,
+                "compression_rules": (
+                    None
+                    if device.compression_rules is None
+                    else [rule.dict() for rule in device.compression_rules]
+                ),
+                "fragmentation_rules": (
+                    None
+                    if device.fragmentation_rules is None
+                    else [rule.dict() for rule in device.fragmentation_rules]
+                ),
+                "uncompressed_rule": (
+                    None
+                    if device.uncompressed_rule is None
+                    else (
+                        device.uncompressed_rule.rule_id,
+                        device.uncompressed_rule.rule_id_size_bits,
+                    )
+                ),
+            }
+            for device in config.devices
+        ]
+
+    @staticmethod
+    def _content_hash(config: Config) -> str:
+        return hashlib.sha256(config.json().encode()).hexdigest()
+
+    @classmethod
+    def compile(cls, config: Config) -> "CompiledConfig":
+        """Lower ``config``, reusing a cached compilation of the same content.
+
+        :param config: The rule configuration to lower.
+        :type config: :class:`Config`
+        :return: The compiled configuration.
+        :rtype: :class:`CompiledConfig`"""
+        key = cls._content_hash(config)
+        try:
+            return cls._cache[key]
+        except KeyError:
+            compiled = cls(config)
+            cls._cache[key] = compiled
+            return compiled
+
+    def deploy(self) -> argparse.Namespace:
+        """Deploys the pre-lowered rule configuration with the binary libSCHC.
+
+        Same contract as :meth:`Config.deploy`, but without any per-rule model
+        validation; devices that already run this exact configuration are left
+        untouched.
+
+        :return: A :class:`argparse.Namespace` with the following attributes:
+
+            - ``devices``: The devices as :class:`pylibschc.device.Device`.
+        :rtype: :class:`argparse.Namespace`"""
+        devices = []
+        for device_config in self._devices:
+            device = pylibschc.device.Device(
+                device_id=device_config["device_id"],
+                mtu=device_config["mtu"],
+                duty_cycle_ms=device_config["duty_cycle_ms"],
+            )
+            device.apply_compiled_rules(
+                device_config["compression_rules"],
+                device_config["fragmentation_rules"],
+                device_config["uncompressed_rule"],
+                content_hash=self.content_hash,
+            )
+            devices.append(device)
+        return argparse.Namespace(devices=devices)
@@ -0,0 +1,74 @@
+# Copyright (C) 2023 Freie Universität Berlin
+#
+# SPDX-License-Identifier: GPL-3.0-only
+
+"""Snapshot access to the hot-path statistics counters of the C layer.
+
+The counters are bumped with relaxed per-thread atomics in ``src/pystats.c``, so
+taking a snapshot does not perturb compression or fragmentation and the values
+can be scraped periodically, e.g. into Prometheus. The counters can be compiled
+out by building with ``NSTATS=1`` (as done for the ``pylibschc.libschc_fast``
+variant), in which case :func:`enabled` returns False and every snapshot is
+all-zero."""
+
+import typing
+
+# pylint: disable=import-error,no-name-in-module
+from .libschc import stats_enabled, stats_snapshot
+
+__author__ = "Martine S. Lenders"
+__copyright__ = "Copyright 2023 Freie Universität Berlin"
+__license__ = "GPLv3"
+__email__ = "m.lenders@fu-berlin.de"
+
+
+class Snapshot(typing.NamedTuple):
+    """The aggregated counters of all threads at one point in time.
+
+    The latency histograms are logarithmic: bucket ``i`` counts calls that took
+    ``2^i <= d < 2^(i+1)`` nanoseconds (see :meth:`Snapshot.bucket_bounds`)."""
+
+    compress_calls: int
+    """Number of calls to ``schc_compress()``."""
+    compress_ns: typing.List[int]
+    """Latency histogram of ``schc_compress()`` calls."""
+    decompress_calls: int
+    """Number of calls to ``schc_decompress()``."""
+    decompress_ns: typing.List[int]
+    """Latency histogram of ``schc_decompress()`` calls."""
+    input_calls: int
+    """Number of datagrams handed to ``schc_input()``."""
+    fragments_sent: int
+    """Number of fragments dispatched to a send callback."""
+    fragment_bytes: int
+    """Number of bytes dispatched to send callbacks."""
+
+    @staticmethod
+    def bucket_bounds() -> typing.List[int]:
+        """The exclusive upper bounds of the latency histogram buckets in
+        nanoseconds.
+
+        :return: ``2^(i+1)`` for every bucket ``i``.
+        :rtype: :class:`typing.List` [ :class:`int` ]"""
+        # take the bucket count from an actual snapshot so it always matches
+        # PYSTATS_NS_BUCKETS of the C layer
+        return [1 << (i + 1) for i in range(len(stats_snapshot()["compress_ns"]))]
+
+
+def enabled() -> bool:
+    """Whether the statistics counters are compiled in.
+
+    :retval False: When the extension was built with ``NSTATS=1``."""
+    return stats_enabled()
+
+
+def snapshot() -> Snapshot:
+    """Take a snapshot of the statistics counters.
+
+    Counters are summed over all threads with relaxed atomics, so the snapshot is
+    not a point-in-time cut across counters, but every value was valid at some
+    moment during the call.
+
+    :return: The current counter values.
+    :rtype: :class:`Snapshot`"""
+    return Snapshot(**stats_snapshot())
@@ -51,6 +51,57 @@ class Build(build):
                 e.cython_directives["embedsignature"] = True
 
 
+LIBSCHC_SOURCES = [
+    "src/id_table.c",
+    "src/pybits.c",
+    "src/pylogging.c",
+    "src/pystats.c",
+    "src/rules.c",
+    "src/send_registry.c",
+    "src/libschc/bit_operations.c",
+    "src/libschc/compressor.c",
+    "src/libschc/fragmenter.c",
+    "src/libschc/jsmn.c",
+    "src/libschc/picocoap.c",
+    "src/libschc/schc.c",
+]
+
+
+def get_ext_modules():
+    ext_modules = [
+        Extension(
+            "pylibschc.libschc",
+            ["pylibschc/libschc.pyx"] + LIBSCHC_SOURCES,
+            include_dirs=["src/libschc", "src", "pylibschc"],
+            extra_compile_args=["-Wno-unused-variable"],
+            define_macros=[],
+        ),
+    ]
+    if os.environ.get("PYLIBSCHC_BUILD_FAST"):
+        # compile-time specialized variant, selectable at import with
+        # PYLIBSCHC_VARIANT=fast; NLOGGING=1 strips DEBUG_PRINTF() from the
+        # libSCHC hot path, NSTATS=1 the statistics counters
+        define_macros = [
+            ("NLOGGING", "1"),
+            ("NSTATS", "1"),
+            ("PYLIBSCHC_MODULE_HEADER", '"libschc_fast.h"'),
+        ]
+        for macro in ["MAX_FIELD_LENGTH", "MAX_MTU_LENGTH"]:
+            value = os.environ.get(f"PYLIBSCHC_{macro}")
+            if value:
+                define_macros.append((macro, value))
+        ext_modules.append(
+            Extension(
+                "pylibschc.libschc_fast",
+                ["pylibschc/libschc_fast.pyx"] + LIBSCHC_SOURCES,
+                include_dirs=["src/libschc", "src", "pylibschc"],
+                extra_compile_args=["-Wno-unused-variable"],
+                define_macros=define_macros,
+            ),
+        )
+    return ext_modules
+
+
 setup(
     name=PACKAGE,
     version=get_version(PACKAGE),
@@ -80,24 +131,6 @@ setup(
     setup_requires=["setuptools>=42", "Cython", "wheel"],
     install_requires=list(get_requirements()),
     cmdclass={"build": Build},
-    ext_modules=[
-        Extension(
-            "pylibschc.libschc",
-            [
-                "pylibschc/libschc.pyx",
-                "src/pylogging.c",
-                "src/rules.c",
-                "src/libschc/bit_operations.c",
-                "src/libschc/compressor.c",
-                "src/libschc/fragmenter.c",
-                "src/libschc/jsmn.c",
-                "src/libschc/picocoap.c",
-                "src/libschc/schc.c",
-            ],
-            include_dirs=["src/libschc", "src", "pylibschc"],
-            extra_compile_args=["-Wno-unused-variable"],
-            define_macros=[],
-        ),
-    ],
+    ext_modules=get_ext_modules(),
     python_requires=">=3.7",
 )
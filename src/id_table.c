@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2023 Freie Universität Berlin
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "id_table.h"
+
+#define ID_TABLE_MIN_SIZE   16U
+
+/* tombstone marking removed entries; only its address is used */
+static char _id_table_deleted;
+#define ID_TABLE_DELETED    ((void *)&_id_table_deleted)
+
+static unsigned _id_table_hash(uint32_t id, unsigned size)
+{
+    /* Knuth multiplicative hash; size is a power of two */
+    return (unsigned)(id * 2654435761U) & (size - 1U);
+}
+
+/* returns 1 when an empty slot was filled, 0 when a tombstone was reused */
+static int _id_table_insert(void **slots, unsigned size, void *entry,
+                            id_table_key_fn_t key)
+{
+    unsigned i = _id_table_hash(key(entry), size);
+
+    while (slots[i] && (slots[i] != ID_TABLE_DELETED)) {
+        i = (i + 1U) & (size - 1U);
+    }
+    if (slots[i] == ID_TABLE_DELETED) {
+        slots[i] = entry;
+        return 0;
+    }
+    slots[i] = entry;
+    return 1;
+}
+
+static int _id_table_resize(id_table_t *table, unsigned size)
+{
+    void **slots = malloc(sizeof(void *) * size);
+
+    if (!slots) {
+        return -1;
+    }
+    memset(slots, 0, sizeof(void *) * size);
+    for (unsigned i = 0; i < table->size; i++) {
+        if (table->slots[i] && (table->slots[i] != ID_TABLE_DELETED)) {
+            _id_table_insert(slots, size, table->slots[i], table->key);
+        }
+    }
+    free(table->slots);
+    table->slots = slots;
+    table->size = size;
+    table->used = table->count;
+    return 0;
+}
+
+int id_table_add(id_table_t *table, void *entry)
+{
+    if ((table->size == 0) &&
+        (_id_table_resize(table, ID_TABLE_MIN_SIZE) < 0)) {
+        return -1;
+    }
+    /* keep the load factor below 3/4, counting tombstones as occupied, so probe
+     * sequences always terminate at an empty slot */
+    if ((((table->used + 1U) * 4U) > (table->size * 3U)) &&
+        (_id_table_resize(table, table->size * 2U) < 0)) {
+        return -1;
+    }
+    table->used += _id_table_insert(table->slots, table->size, entry,
+                                    table->key);
+    table->count++;
+    return 0;
+}
+
+void *id_table_get(const id_table_t *table, uint32_t id)
+{
+    unsigned i;
+
+    if (table->size == 0) {
+        return NULL;
+    }
+    i = _id_table_hash(id, table->size);
+    while (table->slots[i]) {
+        if ((table->slots[i] != ID_TABLE_DELETED) &&
+            (table->key(table->slots[i]) == id)) {
+            return table->slots[i];
+        }
+        i = (i + 1U) & (table->size - 1U);
+    }
+    return NULL;
+}
+
+void *id_table_remove(id_table_t *table, uint32_t id)
+{
+    void *entry = NULL;
+    unsigned i;
+
+    if (table->size == 0) {
+        return NULL;
+    }
+    i = _id_table_hash(id, table->size);
+    while (table->slots[i]) {
+        if ((table->slots[i] != ID_TABLE_DELETED) &&
+            (table->key(table->slots[i]) == id)) {
+            entry = table->slots[i];
+            table->slots[i] = ID_TABLE_DELETED;
+            table->count--;
+            break;
+        }
+        i = (i + 1U) & (table->size - 1U);
+    }
+    if (table->count == 0) {
+        free(table->slots);
+        table->slots = NULL;
+        table->size = 0;
+        table->used = 0;
+    }
+    return entry;
+}
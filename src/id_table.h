@@ -0,0 +1,90 @@
+/* Open-addressing hash table keyed by 32-bit identifiers */
+
+/*
+ * Copyright (C) 2023 Freie Universität Berlin
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#ifndef ID_TABLE_H
+#define ID_TABLE_H
+
+#include <stdint.h>
+
+/**
+ * Returns the identifier an entry is keyed by.
+ *
+ * :param entry: An entry stored in the table.
+ * :type entry: ``const void *``
+ * :return: The identifier of ``entry``.
+ * :rtype: ``uint32_t``
+ */
+typedef uint32_t (*id_table_key_fn_t)(const void *entry);
+
+/**
+ * An open-addressing hash table mapping 32-bit identifiers to entry pointers,
+ * shared by the device index (``rules.c``) and the send-callback registry
+ * (``send_registry.c``). Uses linear probing with tombstones; the table itself
+ * does not lock, callers serialize access themselves.
+ *
+ * Initialize with :c:macro:`ID_TABLE_INIT`.
+ */
+typedef struct {
+    void **slots;           /**< entry pointers; NULL marks an empty slot */
+    unsigned size;          /**< allocated slots, power of two */
+    unsigned used;          /**< occupied slots, including tombstones */
+    unsigned count;         /**< stored entries */
+    id_table_key_fn_t key;  /**< returns the identifier of an entry */
+} id_table_t;
+
+/**
+ * Static initializer for an empty :c:type:`id_table_t` keyed by ``key_fn``.
+ */
+#define ID_TABLE_INIT(key_fn)   { NULL, 0U, 0U, 0U, (key_fn) }
+
+/**
+ * Adds an entry to the table.
+ *
+ * ``entry`` is stored by pointer; the caller keeps ownership. Adding a second
+ * entry with the same identifier does not replace the first, use
+ * :c:func:`id_table_get()` to update entries in place.
+ *
+ * :param table: The table to add to.
+ * :type table: ``id_table_t *``
+ * :param entry: The entry to add. Keyed by ``table->key(entry)``.
+ * :type entry: ``void *``
+ * :retval 0: on success.
+ * :retval -1: when memory for the table can not be allocated.
+ * :rtype: ``int``
+ */
+int id_table_add(id_table_t *table, void *entry);
+
+/**
+ * Resolves an entry by its identifier in O(1).
+ *
+ * :param table: The table to search.
+ * :type table: ``const id_table_t *``
+ * :param id: The identifier of the entry to resolve.
+ * :type id: ``uint32_t``
+ * :return: The entry identified by ``id``.
+ * :retval NULL: when no entry with ``id`` is stored.
+ * :rtype: ``void *``
+ */
+void *id_table_get(const id_table_t *table, uint32_t id);
+
+/**
+ * Removes an entry from the table. The slot array is released when the last
+ * entry is removed.
+ *
+ * :param table: The table to remove from.
+ * :type table: ``id_table_t *``
+ * :param id: The identifier of the entry to remove. No-op when no entry with
+ *     ``id`` is stored.
+ * :type id: ``uint32_t``
+ * :return: The removed entry, for the caller to release.
+ * :retval NULL: when no entry with ``id`` is stored.
+ * :rtype: ``void *``
+ */
+void *id_table_remove(id_table_t *table, uint32_t id);
+
+#endif /* !ID_TABLE_H */
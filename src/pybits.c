@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2023 Freie Universität Berlin
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include <string.h>
+
+#include "pybits.h"
+
+uint32_t pybits_get(const uint8_t *src, uint32_t pos, uint8_t len)
+{
+    const uint8_t *ptr = &src[pos >> 3];
+    unsigned head = pos & 7U;
+    unsigned bytes = (head + len + 7U) >> 3;
+    uint64_t word = 0;
+
+    if (!len) {
+        return 0;
+    }
+    /* load the at most 5 bytes covering the run into one word */
+    for (unsigned i = 0; i < bytes; i++) {
+        word = (word << 8) | ptr[i];
+    }
+    word >>= (bytes * 8U) - head - len;
+    if (len < 32) {
+        word &= ((uint64_t)1 << len) - 1;
+    }
+    return (uint32_t)word;
+}
+
+/* overwrite `len` <= 32 bits at bit position `pos` in `dst` with `val` */
+static void _pybits_put(uint8_t *dst, uint32_t pos, uint32_t val, uint8_t len)
+{
+    uint8_t *ptr = &dst[pos >> 3];
+    unsigned head = pos & 7U;
+    unsigned bytes = (head + len + 7U) >> 3;
+    unsigned tail = (bytes * 8U) - head - len;
+    uint64_t mask = ((((uint64_t)1 << len) - 1)) << tail;
+    uint64_t word = 0;
+
+    for (unsigned i = 0; i < bytes; i++) {
+        word = (word << 8) | ptr[i];
+    }
+    word = (word & ~mask) | (((uint64_t)val << tail) & mask);
+    for (unsigned i = bytes; i-- > 0; ) {
+        ptr[i] = (uint8_t)word;
+        word >>= 8;
+    }
+}
+
+void pybits_overwrite(uint8_t *dst, uint32_t dst_pos,
+                      const uint8_t *src, uint32_t src_pos, uint32_t len)
+{
+    if (!len) {
+        return;
+    }
+    if (!((dst_pos | src_pos) & 7U)) {
+        /* byte-aligned: bulk memcpy, then patch the trailing partial byte */
+        uint32_t bytes = len >> 3;
+        unsigned rem = len & 7U;
+
+        memcpy(&dst[dst_pos >> 3], &src[src_pos >> 3], bytes);
+        if (rem) {
+            uint8_t mask = (uint8_t)(0xFFU << (8U - rem));
+            uint8_t *ptr = &dst[(dst_pos >> 3) + bytes];
+
+            *ptr = (uint8_t)((*ptr & (uint8_t)~mask) |
+                             (src[(src_pos >> 3) + bytes] & mask));
+        }
+        return;
+    }
+    if ((dst_pos & 7U) == (src_pos & 7U)) {
+        /* equal sub-byte phase: one masked head byte, then the aligned path */
+        uint32_t head = 8U - (dst_pos & 7U);
+
+        if (head > len) {
+            head = len;
+        }
+        _pybits_put(dst, dst_pos, pybits_get(src, src_pos, (uint8_t)head),
+                    (uint8_t)head);
+        pybits_overwrite(dst, dst_pos + head, src, src_pos + head, len - head);
+        return;
+    }
+    /* arbitrary phase: move 32 bits per iteration through a shift register */
+    while (len) {
+        uint8_t chunk = (len > 32U) ? 32U : (uint8_t)len;
+
+        _pybits_put(dst, dst_pos, pybits_get(src, src_pos, chunk), chunk);
+        dst_pos += chunk;
+        src_pos += chunk;
+        len -= chunk;
+    }
+}
@@ -0,0 +1,54 @@
+/* Word-at-a-time bit copy/extract kernels for the libSCHC wrapper. */
+
+/*
+ * Copyright (C) 2023 Freie Universität Berlin
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#ifndef PYBITS_H
+#define PYBITS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Read up to 32 bits starting at bit position ``pos`` in ``src``.
+ *
+ * Bits are counted MSB-first, matching libSCHC's ``get_bits()``, but the run
+ * is loaded as one word and shifted instead of bit by bit.
+ *
+ * :param src: buffer to read from
+ * :param pos: position of the first bit in ``src``
+ * :param len: number of bits to read, at most 32
+ * :return: the bits from ``pos`` to ``pos + len`` (exclusive) as an integer
+ */
+uint32_t pybits_get(const uint8_t *src, uint32_t pos, uint8_t len);
+
+/**
+ * Copy ``len`` bits from ``src`` at bit position ``src_pos`` to ``dst`` at bit
+ * position ``dst_pos``, overwriting the destination bits.
+ *
+ * Fuses the ``clear_bits()`` + ``copy_bits()`` pair of libSCHC's OR-ing
+ * ``copy_bits()`` into one pass: byte-aligned runs are ``memcpy()``'d, runs
+ * with equal sub-byte phase get one masked head byte before the aligned path,
+ * and arbitrary phases are moved 32 bits per iteration through a shift
+ * register.
+ *
+ * :param dst: buffer to write to
+ * :param dst_pos: position of the first bit to write in ``dst``
+ * :param src: buffer to read from
+ * :param src_pos: position of the first bit to read in ``src``
+ * :param len: number of bits to copy
+ */
+void pybits_overwrite(uint8_t *dst, uint32_t dst_pos,
+                      const uint8_t *src, uint32_t src_pos, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PYBITS_H */
@@ -4,38 +4,148 @@
  * SPDX-License-Identifier: GPL-3.0-only
  */
 
-#include <pthread.h>
+#include <stdarg.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
-#include "libschc.h"  /* generated from pylibschc/libschc.pyx */
+/* generated from pylibschc/libschc.pyx (or the .pyx of a build variant) */
+#ifdef PYLIBSCHC_MODULE_HEADER
+#include PYLIBSCHC_MODULE_HEADER
+#else
+#include "libschc.h"
+#endif
 
 #include "pylogging.h"
 
-pthread_mutex_t _mutex = PTHREAD_MUTEX_INITIALIZER;
-static char *_concat_buffer = NULL;
-static size_t _concat_buffer_size = 0;
+/* line assembly is per thread, so concurrent logging threads neither serialize
+ * on a mutex nor garble each other's lines */
+static _Thread_local char _concat_storage[PYLOG_BUFFER_SIZE];
+static _Thread_local char *_concat_buffer = NULL;
+static _Thread_local size_t _concat_buffer_size = 0;
+
+/* lock-free MPSC ring buffering completed lines until a GIL-holding thread
+ * (or the background drainer) forwards them to the Python logging module */
+typedef struct {
+    atomic_uint_fast32_t seq;   /* == claim position + 1 when the record is ready */
+    char str[PYLOG_BUFFER_SIZE];
+} _pylog_record_t;
+
+static _pylog_record_t _ring[PYLOG_RING_SIZE];
+static atomic_uint_fast32_t _ring_head;
+static atomic_uint_fast32_t _ring_tail;
+static atomic_uint_fast32_t _ring_dropped;
+static atomic_flag _flushing = ATOMIC_FLAG_INIT;
+static atomic_bool _drainer_started;
+/* cached result of pylog_in_debug(); -1 means unknown */
+static atomic_int _debug_cache = -1;
+
+static int _pylog_in_debug_cached(void)
+{
+    int cached;
+
+    if (PyGILState_Check()) {
+        /* querying Python is exact while the GIL is already held; also keeps the
+         * cache fresh for the GIL-less hot paths */
+        cached = pylog_in_debug();
+        atomic_store(&_debug_cache, cached);
+        return cached;
+    }
+    cached = atomic_load(&_debug_cache);
+    if (cached < 0) {
+        PyGILState_STATE state = PyGILState_Ensure();
+
+        cached = pylog_in_debug();
+        atomic_store(&_debug_cache, cached);
+        PyGILState_Release(state);
+    }
+    return cached;
+}
+
+int pylog_flush(void)
+{
+    uint_fast32_t tail;
+    uint_fast32_t dropped;
+    int count = 0;
+
+    if (atomic_flag_test_and_set(&_flushing)) {
+        /* another thread is draining already */
+        return 0;
+    }
+    atomic_store(&_debug_cache, pylog_in_debug());
+    tail = atomic_load_explicit(&_ring_tail, memory_order_relaxed);
+    for (;;) {
+        _pylog_record_t *record = &_ring[tail & (PYLOG_RING_SIZE - 1U)];
+
+        if (atomic_load_explicit(&record->seq, memory_order_acquire)
+            != (tail + 1U)) {
+            break;
+        }
+        pylog_call_debug(record->str);
+        count++;
+        tail++;
+        atomic_store_explicit(&_ring_tail, tail, memory_order_release);
+    }
+    dropped = atomic_exchange(&_ring_dropped, 0);
+    if (dropped > 0) {
+        char str[64];
+
+        snprintf(str, sizeof(str), "pylogging: dropped %u log records",
+                 (unsigned)dropped);
+        pylog_call_debug(str);
+    }
+    atomic_flag_clear(&_flushing);
+    return count;
+}
+
+static void _pylog_emit(const char *str, size_t size)
+{
+    _pylog_record_t *record;
+    uint_fast32_t pos;
+
+    if (size >= PYLOG_BUFFER_SIZE) {
+        size = PYLOG_BUFFER_SIZE - 1U;
+    }
+    /* claim a slot; drop the record when the ring is full */
+    pos = atomic_load_explicit(&_ring_head, memory_order_relaxed);
+    do {
+        if ((pos - atomic_load_explicit(&_ring_tail, memory_order_acquire))
+            >= PYLOG_RING_SIZE) {
+            atomic_fetch_add(&_ring_dropped, 1);
+            return;
+        }
+    } while (!atomic_compare_exchange_weak(&_ring_head, &pos, pos + 1U));
+    record = &_ring[pos & (PYLOG_RING_SIZE - 1U)];
+    memcpy(record->str, str, size);
+    record->str[size] = '\0';
+    atomic_store_explicit(&record->seq, pos + 1U, memory_order_release);
+    if (PyGILState_Check()) {
+        /* forward synchronously; this also drains records left behind by
+         * GIL-less logging threads */
+        pylog_flush();
+    }
+    else if (!atomic_exchange(&_drainer_started, true)) {
+        PyGILState_STATE state = PyGILState_Ensure();
+
+        pylog_start_drainer();
+        PyGILState_Release(state);
+    }
+}
 
 int pylog_debug(const char *format, ...)
 {
-    if (pylog_in_debug()) {
+    if (_pylog_in_debug_cached()) {
         va_list args;
         int size = PYLOG_BUFFER_SIZE;
-        char *str;
-        bool str_malloced = true;
+        char *str = _concat_storage;
+
         /* if concat buffer is initialized, let vsnprintf continue concatenation */
-        pthread_mutex_lock(&_mutex);
         if (_concat_buffer) {
             str = &_concat_buffer[_concat_buffer_size];
             size -= _concat_buffer_size;
-            str_malloced = false;
-        }
-        /* else, allocate a new string */
-        else if ((str = (char *)malloc(sizeof(char) * size)) == NULL) {
-            size = -1;
-            goto early_out;
         }
         va_start(args, format);
         size = vsnprintf(str, size, format, args);
@@ -66,22 +176,13 @@ int pylog_debug(const char *format, ...)
         }
         if (_concat_buffer) {  /* if concat buffer is initialized, log it */
             str = &_concat_buffer[0];
-            size = _concat_buffer_size;
+            size = strlen(str);
         }
-        pylog_call_debug(str);
+        _pylog_emit(str, size);
 end:
-        if (str_malloced) {
-            free(str);
-        }
-        else {
-            if (_concat_buffer) {
-                free(_concat_buffer);
-            }
-        }
         _concat_buffer = NULL;
         _concat_buffer_size = 0;
 early_out:
-        pthread_mutex_unlock(&_mutex);
         return size;
     }
     return 0;
@@ -16,13 +16,32 @@
  */
 #define PYLOG_BUFFER_SIZE   1024
 
+/**
+ * Number of completed lines the logging ring buffer can hold before records
+ * are dropped. Must be a power of two.
+ */
+#define PYLOG_RING_SIZE     64U
+
 /**
  * Add a record to the python loggers :py:data:`logging.DEBUG` log.
  *
  * :param format: a ``printf()`` format string
  *
  * The remaining parameters will be formatted as with ``printf()``
+ *
+ * When the caller holds the GIL the record is forwarded to the logging module
+ * synchronously. Callers without the GIL only append to a lock-free ring
+ * buffer; a background drainer forwards those records eventually.
  */
 int pylog_debug(const char *format, ...);
 
+/**
+ * Forward all buffered log records to the python logging module.
+ *
+ * Must be called with the GIL held.
+ *
+ * :return: the number of records forwarded.
+ */
+int pylog_flush(void);
+
 #endif /* PYLOGGING_H */
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2023 Freie Universität Berlin
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "schc_config.h"
+#include "pystats.h"
+
+#if !NSTATS
+
+#include <stdatomic.h>
+
+/* Each thread bumps its own heap-allocated counter block with relaxed
+ * atomics, so the hot path never contends on a shared cache line; a snapshot
+ * walks the list of blocks and sums them. */
+typedef struct _pystats_block {
+    struct _pystats_block *next;
+    atomic_uint_fast64_t compress_calls;
+    atomic_uint_fast64_t compress_ns[PYSTATS_NS_BUCKETS];
+    atomic_uint_fast64_t decompress_calls;
+    atomic_uint_fast64_t decompress_ns[PYSTATS_NS_BUCKETS];
+    atomic_uint_fast64_t input_calls;
+    atomic_uint_fast64_t fragments_sent;
+    atomic_uint_fast64_t fragment_bytes;
+} _pystats_block_t;
+
+static _pystats_block_t *_Atomic _blocks = NULL;
+static _Thread_local _pystats_block_t *_block = NULL;
+
+static _pystats_block_t *_pystats_block(void)
+{
+    _pystats_block_t *head;
+
+    if (_block) {
+        return _block;
+    }
+    /* blocks are deliberately never freed: a snapshot may still read them
+     * after the owning thread exited, and the number of threads bumping
+     * counters over the lifetime of a process is small */
+    _block = calloc(1, sizeof(_pystats_block_t));
+    if (!_block) {
+        return NULL;
+    }
+    head = atomic_load_explicit(&_blocks, memory_order_relaxed);
+    do {
+        _block->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(
+        &_blocks, &head, _block, memory_order_release, memory_order_relaxed
+    ));
+    return _block;
+}
+
+static unsigned _pystats_bucket(uint64_t ns)
+{
+    unsigned bucket = 0;
+
+    while ((ns >>= 1) && (bucket < (PYSTATS_NS_BUCKETS - 1U))) {
+        bucket++;
+    }
+    return bucket;
+}
+
+static inline void _pystats_add(atomic_uint_fast64_t *counter, uint64_t value)
+{
+    atomic_fetch_add_explicit(counter, value, memory_order_relaxed);
+}
+
+uint64_t pystats_now_ns(void)
+{
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) < 0) {
+        return 0;
+    }
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+void pystats_record_compress(uint64_t ns)
+{
+    _pystats_block_t *block = _pystats_block();
+
+    if (!block) {
+        return;
+    }
+    _pystats_add(&block->compress_calls, 1);
+    _pystats_add(&block->compress_ns[_pystats_bucket(ns)], 1);
+}
+
+void pystats_record_decompress(uint64_t ns)
+{
+    _pystats_block_t *block = _pystats_block();
+
+    if (!block) {
+        return;
+    }
+    _pystats_add(&block->decompress_calls, 1);
+    _pystats_add(&block->decompress_ns[_pystats_bucket(ns)], 1);
+}
+
+void pystats_count_input(void)
+{
+    _pystats_block_t *block = _pystats_block();
+
+    if (!block) {
+        return;
+    }
+    _pystats_add(&block->input_calls, 1);
+}
+
+void pystats_count_fragment_sent(uint16_t length)
+{
+    _pystats_block_t *block = _pystats_block();
+
+    if (!block) {
+        return;
+    }
+    _pystats_add(&block->fragments_sent, 1);
+    _pystats_add(&block->fragment_bytes, length);
+}
+
+void pystats_snapshot(pystats_counters_t *out)
+{
+    _pystats_block_t *block = atomic_load_explicit(
+        &_blocks, memory_order_acquire
+    );
+
+    memset(out, 0, sizeof(*out));
+    for (; block; block = block->next) {
+        out->compress_calls += atomic_load_explicit(
+            &block->compress_calls, memory_order_relaxed
+        );
+        out->decompress_calls += atomic_load_explicit(
+            &block->decompress_calls, memory_order_relaxed
+        );
+        out->input_calls += atomic_load_explicit(
+            &block->input_calls, memory_order_relaxed
+        );
+        out->fragments_sent += atomic_load_explicit(
+            &block->fragments_sent, memory_order_relaxed
+        );
+        out->fragment_bytes += atomic_load_explicit(
+            &block->fragment_bytes, memory_order_relaxed
+        );
+        for (unsigned i = 0; i < PYSTATS_NS_BUCKETS; i++) {
+            out->compress_ns[i] += atomic_load_explicit(
+                &block->compress_ns[i], memory_order_relaxed
+            );
+            out->decompress_ns[i] += atomic_load_explicit(
+                &block->decompress_ns[i], memory_order_relaxed
+            );
+        }
+    }
+}
+
+#else /* !NSTATS */
+
+uint64_t pystats_now_ns(void)
+{
+    return 0;
+}
+
+void pystats_record_compress(uint64_t ns)
+{
+    (void)ns;
+}
+
+void pystats_record_decompress(uint64_t ns)
+{
+    (void)ns;
+}
+
+void pystats_count_input(void)
+{
+}
+
+void pystats_count_fragment_sent(uint16_t length)
+{
+    (void)length;
+}
+
+void pystats_snapshot(pystats_counters_t *out)
+{
+    memset(out, 0, sizeof(*out));
+}
+
+#endif /* !NSTATS */
+
+int pystats_enabled(void)
+{
+    return !NSTATS;
+}
@@ -0,0 +1,92 @@
+/* Hot-path statistics counters for the libSCHC wrapper. */
+
+/*
+ * Copyright (C) 2023 Freie Universität Berlin
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#ifndef PYSTATS_H
+#define PYSTATS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Number of logarithmic latency buckets: bucket ``i`` counts durations ``d``
+ * with ``2^i <= d < 2^(i+1)`` nanoseconds (bucket 0 also counts ``d < 1``).
+ */
+#define PYSTATS_NS_BUCKETS  32U
+
+/**
+ * A consistent sum over the counters of all threads, as filled by
+ * :c:func:`pystats_snapshot`.
+ */
+typedef struct {
+    /** calls to ``schc_compress()`` */
+    uint64_t compress_calls;
+    /** ``schc_compress()`` latency histogram */
+    uint64_t compress_ns[PYSTATS_NS_BUCKETS];
+    /** calls to ``schc_decompress()`` */
+    uint64_t decompress_calls;
+    /** ``schc_decompress()`` latency histogram */
+    uint64_t decompress_ns[PYSTATS_NS_BUCKETS];
+    /** datagrams handed to ``schc_input()`` */
+    uint64_t input_calls;
+    /** fragments dispatched to a send callback */
+    uint64_t fragments_sent;
+    /** bytes dispatched to send callbacks */
+    uint64_t fragment_bytes;
+} pystats_counters_t;
+
+/**
+ * :return: the current value of a monotonic clock in nanoseconds
+ *          (0 when the counters are compiled out with ``NSTATS=1``).
+ */
+uint64_t pystats_now_ns(void);
+
+/**
+ * Count a ``schc_compress()`` call that took ``ns`` nanoseconds.
+ */
+void pystats_record_compress(uint64_t ns);
+
+/**
+ * Count a ``schc_decompress()`` call that took ``ns`` nanoseconds.
+ */
+void pystats_record_decompress(uint64_t ns);
+
+/**
+ * Count a datagram handed to ``schc_input()``.
+ */
+void pystats_count_input(void);
+
+/**
+ * Count a fragment of ``length`` bytes dispatched to a send callback.
+ */
+void pystats_count_fragment_sent(uint16_t length);
+
+/**
+ * Sum the counters of all threads into ``out``.
+ *
+ * Counters are bumped per thread with relaxed atomics, so the snapshot is not a
+ * point-in-time cut across counters, but every counter value was valid at some
+ * moment during the call.
+ *
+ * :param out: filled with the aggregated counters (zeroed when the counters are
+ *             compiled out with ``NSTATS=1``).
+ */
+void pystats_snapshot(pystats_counters_t *out);
+
+/**
+ * :return: 1 when the counters are compiled in, 0 when ``NSTATS=1`` was set.
+ */
+int pystats_enabled(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PYSTATS_H */
@@ -4,109 +4,160 @@
  * SPDX-License-Identifier: GPL-3.0-only
  */
 
+#include <pthread.h>
+#include <stddef.h>
 #include <stdlib.h>
-#include <string.h>
 
 #include "schc.h"
 #include "rules/rule_config.h"
 
+#include "id_table.h"
 #include "rules.h"
 
 
 int DEVICE_COUNT = 0;
 struct schc_device **devices = NULL;
 
+static uint32_t _device_key(const void *entry)
+{
+    return ((const struct schc_device *)entry)->device_id;
+}
+
+/* serializes device index access for callers outside the GIL (paced TX
+ * threads, free-threaded builds) */
+static pthread_mutex_t _device_index_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static id_table_t _device_index = ID_TABLE_INIT(_device_key);
+
+int schc_rules_device_index_add(struct schc_device *device)
+{
+    int res;
+
+    pthread_mutex_lock(&_device_index_lock);
+    res = id_table_add(&_device_index, device);
+    pthread_mutex_unlock(&_device_index_lock);
+    return res;
+}
+
+void schc_rules_device_index_remove(uint32_t device_id)
+{
+    pthread_mutex_lock(&_device_index_lock);
+    /* the index does not own the device, nothing to release */
+    id_table_remove(&_device_index, device_id);
+    pthread_mutex_unlock(&_device_index_lock);
+}
+
+struct schc_device *schc_rules_get_device_by_id(uint32_t device_id)
+{
+    struct schc_device *device;
+
+    pthread_mutex_lock(&_device_index_lock);
+    device = id_table_get(&_device_index, device_id);
+    pthread_mutex_unlock(&_device_index_lock);
+    return device;
+}
+
+/* keep subsequent arena allocations naturally aligned */
+#define ARENA_ALIGN(size) \
+    (((size) + (sizeof(max_align_t) - 1U)) & ~(sizeof(max_align_t) - 1U))
+
+/* arena backing one device's compression context: the rule pointer array, the
+ * rules, and their layer rules live in one contiguous allocation, so the whole
+ * context is cache-adjacent and freed with a single free() */
+struct rules_arena {
+    size_t offset;      /* bump allocation offset into mem */
+    size_t size;
+    uint8_t mem[];
+};
+
+static struct rules_arena *_arena_of(struct schc_compression_rule_t **ctx)
+{
+    /* the pointer array is the first allocation within the arena */
+    return (struct rules_arena *)((uint8_t *)ctx - offsetof(struct rules_arena, mem));
+}
+
+static void *_arena_alloc(struct rules_arena *arena, size_t size)
+{
+    void *ptr;
+
+    size = ARENA_ALIGN(size);
+    if ((arena->offset + size) > arena->size) {
+        return NULL;
+    }
+    ptr = &arena->mem[arena->offset];
+    arena->offset += size;
+    return ptr;
+}
+
 struct schc_compression_rule_t **schc_rules_create_compr_ctx(unsigned rule_count)
 {
-    struct schc_compression_rule_t **ctx = malloc(
-        sizeof(struct schc_compression_rule_t) * rule_count
-    );
-    if (ctx) {
-        for (unsigned i = 0; i < rule_count; i++) {
-            /* TODO protect against NULL return */
-            ctx[i] = malloc(sizeof(struct schc_compression_rule_t));
-            *(ctx[i]) = (struct schc_compression_rule_t){ 0 };
-        }
+    /* worst case: every rule brings its own set of layer rules */
+    const size_t size = ARENA_ALIGN(sizeof(struct schc_compression_rule_t *) * rule_count)
+        + (rule_count * (ARENA_ALIGN(sizeof(struct schc_compression_rule_t))
+                         + ARENA_ALIGN(sizeof(struct schc_ipv6_rule_t))
+                         + ARENA_ALIGN(sizeof(struct schc_udp_rule_t))
+                         + ARENA_ALIGN(sizeof(struct schc_coap_rule_t))));
+    struct rules_arena *arena = malloc(sizeof(struct rules_arena) + size);
+    struct schc_compression_rule_t **ctx;
+
+    if (!arena) {
+        return NULL;
+    }
+    arena->offset = 0;
+    arena->size = size;
+    ctx = _arena_alloc(arena, sizeof(struct schc_compression_rule_t *) * rule_count);
+    for (unsigned i = 0; i < rule_count; i++) {
+        /* can not fail, the arena is sized for the worst case */
+        ctx[i] = _arena_alloc(arena, sizeof(struct schc_compression_rule_t));
+        *(ctx[i]) = (struct schc_compression_rule_t){ 0 };
     }
     return ctx;
 }
 
-struct schc_ipv6_rule_t *schc_rules_create_ipv6_rule(void)
+struct schc_ipv6_rule_t *schc_rules_create_ipv6_rule(struct schc_compression_rule_t **ctx)
 {
-    return malloc(sizeof(struct schc_ipv6_rule_t));
+    return _arena_alloc(_arena_of(ctx), sizeof(struct schc_ipv6_rule_t));
 }
 
-struct schc_udp_rule_t *schc_rules_create_udp_rule(void)
+struct schc_udp_rule_t *schc_rules_create_udp_rule(struct schc_compression_rule_t **ctx)
 {
-    return malloc(sizeof(struct schc_udp_rule_t));
+    return _arena_alloc(_arena_of(ctx), sizeof(struct schc_udp_rule_t));
 }
 
-struct schc_coap_rule_t *schc_rules_create_coap_rule(void)
+struct schc_coap_rule_t *schc_rules_create_coap_rule(struct schc_compression_rule_t **ctx)
 {
-    return malloc(sizeof(struct schc_coap_rule_t));
+    return _arena_alloc(_arena_of(ctx), sizeof(struct schc_coap_rule_t));
 }
 
 struct schc_fragmentation_rule_t **schc_rules_create_frag_ctx(unsigned rule_count)
 {
+    /* pointer array and rules share one allocation */
     struct schc_fragmentation_rule_t **ctx = malloc(
-        sizeof(struct schc_fragmentation_rule_t) * rule_count
+        (sizeof(struct schc_fragmentation_rule_t *) * rule_count)
+        + (sizeof(struct schc_fragmentation_rule_t) * rule_count)
     );
+    struct schc_fragmentation_rule_t *rules;
+
     if (ctx) {
+        rules = (struct schc_fragmentation_rule_t *)&ctx[rule_count];
         for (unsigned i = 0; i < rule_count; i++) {
-            /* TODO protect against NULL return */
-            ctx[i] = malloc(sizeof(struct schc_fragmentation_rule_t));
+            ctx[i] = &rules[i];
             *(ctx[i]) = (struct schc_fragmentation_rule_t){ 0 };
         }
     }
     return ctx;
 }
 
-static int _already_freed(void *rule, void **freed_layer_rules)
-{
-    int i = 0;
-
-    /* determine already free'd pointers */
-    while (freed_layer_rules[i]) {
-        if (rule == freed_layer_rules[i]) {
-            return 1;
-        }
-        i++;
-    }
-    freed_layer_rules[i] = rule;
-    return 0;
-}
-
-static void _free_compr_rule(struct schc_compression_rule_t *ctx, void **freed_layer_rules)
-{
-    if (ctx->ipv6_rule && !_already_freed(ctx->ipv6_rule, freed_layer_rules)) {
-        free(ctx->ipv6_rule);
-    }
-    if (ctx->udp_rule && !_already_freed(ctx->udp_rule, freed_layer_rules)) {
-        free(ctx->udp_rule);
-    }
-    if (ctx->coap_rule && !_already_freed(ctx->coap_rule, freed_layer_rules)) {
-        free(ctx->coap_rule);
-    }
-    free(ctx);
-}
-
 void schc_rules_free_compr_ctx(struct schc_compression_rule_t **ctx, unsigned rule_count)
 {
-    const size_t freed_layer_rules_size = (sizeof(void *) * rule_count * 3U) + 1;
-    void *freed_layer_rules = malloc(freed_layer_rules_size);
-
-    memset(freed_layer_rules, 0, freed_layer_rules_size);
-    for (unsigned i = 0; i < rule_count; i++) {
-        _free_compr_rule(ctx[i], freed_layer_rules);
+    (void)rule_count;
+    if (ctx) {
+        free(_arena_of(ctx));
     }
-    free(freed_layer_rules);
-    free(ctx);
 }
 
 void schc_rules_free_frag_ctx(struct schc_fragmentation_rule_t **ctx, unsigned rule_count)
 {
-    for (unsigned i = 0; i < rule_count; i++) {
-        free(ctx[i]);
-    }
+    (void)rule_count;
     free(ctx);
 }
@@ -9,9 +9,47 @@
 #ifndef RULES_H
 #define RULES_H
 
+#include <stdint.h>
+
+/**
+ * Adds a device to the hash-based device index.
+ *
+ * :param device: The device to index. Keyed by its ``device_id`` member.
+ * :type device: ``struct schc_device *``
+ * :retval 0: on success.
+ * :retval -1: when memory for the index can not be allocated.
+ * :rtype: ``int``
+ */
+int schc_rules_device_index_add(struct schc_device *device);
+
+/**
+ * Removes a device from the hash-based device index.
+ *
+ * :param device_id: The identifier of the device to remove. No-op when no device with
+ *     ``device_id`` is indexed.
+ * :type device_id: ``uint32_t``
+ */
+void schc_rules_device_index_remove(uint32_t device_id);
+
+/**
+ * Resolves a device by its identifier in O(1) via the hash-based device index.
+ *
+ * :param device_id: The identifier of the device to resolve.
+ * :type device_id: ``uint32_t``
+ * :return: The device identified by ``device_id``.
+ * :retval NULL: when no device with ``device_id`` is indexed.
+ * :rtype: ``struct schc_device *``
+ */
+struct schc_device *schc_rules_get_device_by_id(uint32_t device_id);
+
 /**
  * Allocates the array for the compression context of a device.
  *
+ * The context is backed by a per-device arena sized for the worst case of
+ * ``rule_count`` rules with all their layer rules, so all rules of a device are
+ * contiguous in memory and the context is freed with a single ``free()`` by
+ * :func:`schc_rules_free_compr_ctx()`.
+ *
  * :param rule_count: The number of rule entries to be added to the compression context.
  * :type rule_count: unsigned
  * :return: An array of allocates ``struct schc_compression_rule_t`` pointers.
@@ -21,31 +59,37 @@
 struct schc_compression_rule_t **schc_rules_create_compr_ctx(unsigned rule_count);
 
 /**
- * Allocate an IPv6 layer rule
+ * Allocate an IPv6 layer rule from the arena of ``ctx``.
  *
+ * :param ctx: A context created with :func:`schc_rules_create_compr_ctx()`.
+ * :type ctx: ``struct schc_compression_rule_t **``
  * :return: A ``struct schc_ipv6_rule_t`` pointer.
  * :retval NULL: when the layer rule can not be allocated.
  * :rtype: ``struct schc_ipv6_rule_t *``
  */
-struct schc_ipv6_rule_t *schc_rules_create_ipv6_rule(void);
+struct schc_ipv6_rule_t *schc_rules_create_ipv6_rule(struct schc_compression_rule_t **ctx);
 
 /**
- * Allocate an UDP layer rule
+ * Allocate an UDP layer rule from the arena of ``ctx``.
  *
+ * :param ctx: A context created with :func:`schc_rules_create_compr_ctx()`.
+ * :type ctx: ``struct schc_compression_rule_t **``
  * :return: A ``struct schc_udp_rule_t`` pointer.
  * :retval NULL: when the layer rule can not be allocated.
  * :rtype: ``struct schc_udp_rule_t *``
  */
-struct schc_udp_rule_t *schc_rules_create_udp_rule(void);
+struct schc_udp_rule_t *schc_rules_create_udp_rule(struct schc_compression_rule_t **ctx);
 
 /**
- * Allocate an CoAP layer rule
+ * Allocate an CoAP layer rule from the arena of ``ctx``.
  *
+ * :param ctx: A context created with :func:`schc_rules_create_compr_ctx()`.
+ * :type ctx: ``struct schc_compression_rule_t **``
  * :return: A ``struct schc_coap_rule_t`` pointer.
  * :retval NULL: when the layer rule can not be allocated.
  * :rtype: ``struct schc_coap_rule_t *``
  */
-struct schc_coap_rule_t *schc_rules_create_coap_rule(void);
+struct schc_coap_rule_t *schc_rules_create_coap_rule(struct schc_compression_rule_t **ctx);
 
 /**
  * Allocates the array for the fragmentation context of a device.
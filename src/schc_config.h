@@ -28,6 +28,17 @@
 #include "pylogging.h"
 #endif
 
+#ifndef NSTATS
+/**
+ * :value: 0
+ *
+ * Toggle the hot-path statistics counters at compile time: ``NSTATS=0`` means the
+ * counters declared in pystats.h are maintained, ``NSTATS=1`` means all counter
+ * bumps are compiled out.
+ */
+#define NSTATS                          0
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -60,13 +71,17 @@ extern "C" {
  */
 #define USE_IP6_UDP                     1
 
+#ifndef MAX_FIELD_LENGTH
 /**
  * :value: 32
  *
  * The maximum length of a single header field,
  * e.g., you can use 4 ipv6 source iid addresses with match-mapping.
+ * Can be overridden at compile time, e.g., to increase cache density of rule
+ * scans for deployments with short fields.
  */
 #define MAX_FIELD_LENGTH                32
+#endif
 
 /**
  * :value: 14
@@ -117,12 +132,15 @@ extern "C" {
  */
 #define MAX_COAP_MSG_SIZE               MAX_COAP_HEADER_LENGTH + MAX_PAYLOAD_LENGTH
 
+#ifndef MAX_MTU_LENGTH
 /**
  * :value: 1280
  *
  * The maximum transfer unit of the underlying technology.
+ * Can be overridden at compile time.
  */
 #define MAX_MTU_LENGTH                  1280
+#endif
 
 /**
  * :value: 1
@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2023 Freie Universität Berlin
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#define _GNU_SOURCE     /* sendmmsg() */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#include "schc_config.h"
+
+/* generated from pylibschc/libschc.pyx (or the .pyx of a build variant) */
+#ifdef PYLIBSCHC_MODULE_HEADER
+#include PYLIBSCHC_MODULE_HEADER
+#else
+#include "libschc.h"
+#endif
+
+#include "id_table.h"
+#include "pystats.h"
+#include "send_registry.h"
+
+typedef struct {
+    uint32_t device_id;
+    schc_send_fn_t send;
+    void *ctx;
+} _send_entry_t;
+
+static uint32_t _send_entry_key(const void *entry)
+{
+    return ((const _send_entry_t *)entry)->device_id;
+}
+
+/* serializes registry access for callers outside the GIL (paced TX threads,
+ * free-threaded builds); dispatch copies the entry and calls it unlocked */
+static pthread_mutex_t _send_registry_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static id_table_t _send_registry = ID_TABLE_INIT(_send_entry_key);
+
+/* per-device state of the scatter-gather send backend: fragments are staged
+ * into the slots (the fragmenter reuses its fragment buffer right after the
+ * send callback returns) and leave in one sendmmsg(2) call per batch */
+typedef struct {
+    pthread_mutex_t lock;
+    int sockfd;
+    unsigned count;
+    uint16_t lengths[SCHC_SEND_MMSG_BATCH];
+    uint8_t slots[SCHC_SEND_MMSG_BATCH][MAX_MTU_LENGTH];
+} _mmsg_backend_t;
+
+/* sends out the staged fragments of `backend`; must hold backend->lock */
+static int _mmsg_flush(_mmsg_backend_t *backend)
+{
+    unsigned count = backend->count;
+
+    if (count == 0) {
+        return 0;
+    }
+    backend->count = 0;
+#ifdef __linux__
+    struct mmsghdr msgs[SCHC_SEND_MMSG_BATCH];
+    struct iovec iovs[SCHC_SEND_MMSG_BATCH];
+    unsigned sent = 0;
+
+    memset(msgs, 0, sizeof(struct mmsghdr) * count);
+    for (unsigned i = 0; i < count; i++) {
+        iovs[i].iov_base = backend->slots[i];
+        iovs[i].iov_len = backend->lengths[i];
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    /* one syscall for the whole batch */
+    while (sent < count) {
+        int res = sendmmsg(backend->sockfd, &msgs[sent], count - sent, 0);
+
+        if (res < 0) {
+            return -1;
+        }
+        sent += (unsigned)res;
+    }
+#else
+    for (unsigned i = 0; i < count; i++) {
+        if (send(backend->sockfd, backend->slots[i],
+                 backend->lengths[i], 0) < 0) {
+            return -1;
+        }
+    }
+#endif
+    return (int)count;
+}
+
+static uint8_t _send_mmsg(void *ctx, uint8_t *data, uint16_t length)
+{
+    _mmsg_backend_t *backend = ctx;
+    uint8_t res = (uint8_t)length;
+
+    if (length > MAX_MTU_LENGTH) {
+        return 0;
+    }
+    pthread_mutex_lock(&backend->lock);
+    memcpy(backend->slots[backend->count], data, length);
+    backend->lengths[backend->count] = length;
+    if ((++backend->count == SCHC_SEND_MMSG_BATCH) &&
+        (_mmsg_flush(backend) < 0)) {
+        res = 0;
+    }
+    pthread_mutex_unlock(&backend->lock);
+    return res;
+}
+
+/* flushes and frees the backend of `entry` when it is a scatter-gather one */
+static void _mmsg_backend_release(_send_entry_t *entry)
+{
+    if (entry->send == _send_mmsg) {
+        _mmsg_backend_t *backend = entry->ctx;
+
+        pthread_mutex_lock(&backend->lock);
+        _mmsg_flush(backend);
+        pthread_mutex_unlock(&backend->lock);
+        pthread_mutex_destroy(&backend->lock);
+        free(backend);
+    }
+}
+
+static int _schc_send_register(uint32_t device_id, schc_send_fn_t send, void *ctx)
+{
+    _send_entry_t *entry = id_table_get(&_send_registry, device_id);
+
+    if (entry) {
+        _mmsg_backend_release(entry);
+        entry->send = send;
+        entry->ctx = ctx;
+        return 0;
+    }
+    entry = malloc(sizeof(_send_entry_t));
+    if (!entry) {
+        return -1;
+    }
+    entry->device_id = device_id;
+    entry->send = send;
+    entry->ctx = ctx;
+    if (id_table_add(&_send_registry, entry) < 0) {
+        free(entry);
+        return -1;
+    }
+    return 0;
+}
+
+int schc_send_register(uint32_t device_id, schc_send_fn_t send, void *ctx)
+{
+    int res;
+
+    pthread_mutex_lock(&_send_registry_lock);
+    res = _schc_send_register(device_id, send, ctx);
+    pthread_mutex_unlock(&_send_registry_lock);
+    return res;
+}
+
+void schc_send_unregister(uint32_t device_id)
+{
+    _send_entry_t *entry;
+
+    pthread_mutex_lock(&_send_registry_lock);
+    entry = id_table_remove(&_send_registry, device_id);
+    if (entry) {
+        _mmsg_backend_release(entry);
+        free(entry);
+    }
+    pthread_mutex_unlock(&_send_registry_lock);
+}
+
+static uint8_t _send_udp(void *ctx, uint8_t *data, uint16_t length)
+{
+    ssize_t res = send((int)(intptr_t)ctx, data, length, 0);
+
+    return (res < 0) ? 0 : (uint8_t)res;
+}
+
+int schc_send_register_udp(uint32_t device_id, int sockfd)
+{
+    return schc_send_register(device_id, _send_udp, (void *)(intptr_t)sockfd);
+}
+
+int schc_send_register_mmsg(uint32_t device_id, int sockfd)
+{
+    _mmsg_backend_t *backend = malloc(sizeof(_mmsg_backend_t));
+    int res;
+
+    if (!backend) {
+        return -1;
+    }
+    pthread_mutex_init(&backend->lock, NULL);
+    backend->sockfd = sockfd;
+    backend->count = 0;
+    res = schc_send_register(device_id, _send_mmsg, backend);
+    if (res < 0) {
+        pthread_mutex_destroy(&backend->lock);
+        free(backend);
+    }
+    return res;
+}
+
+int schc_send_flush(uint32_t device_id)
+{
+    _send_entry_t *entry;
+    int res = 0;
+
+    pthread_mutex_lock(&_send_registry_lock);
+    entry = id_table_get(&_send_registry, device_id);
+    if (entry && (entry->send == _send_mmsg)) {
+        _mmsg_backend_t *backend = entry->ctx;
+
+        pthread_mutex_lock(&backend->lock);
+        res = _mmsg_flush(backend);
+        pthread_mutex_unlock(&backend->lock);
+    }
+    pthread_mutex_unlock(&_send_registry_lock);
+    return res;
+}
+
+int schc_send_is_registered(uint32_t device_id)
+{
+    int res;
+
+    pthread_mutex_lock(&_send_registry_lock);
+    res = (id_table_get(&_send_registry, device_id) != NULL);
+    pthread_mutex_unlock(&_send_registry_lock);
+    return res;
+}
+
+uint8_t schc_send_dispatch(uint8_t *data, uint16_t length, uint32_t device_id)
+{
+    _send_entry_t entry = { 0 };
+    const _send_entry_t *found;
+
+    pystats_count_fragment_sent(length);
+    pthread_mutex_lock(&_send_registry_lock);
+    found = id_table_get(&_send_registry, device_id);
+    if (found) {
+        entry = *found;
+    }
+    pthread_mutex_unlock(&_send_registry_lock);
+    if (entry.send) {
+        return entry.send(entry.ctx, data, length);
+    }
+    return pysend_call(data, length, device_id);
+}
@@ -0,0 +1,146 @@
+/* C-level send-callback registry for fragment transmission */
+
+/*
+ * Copyright (C) 2023 Freie Universität Berlin
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#ifndef SEND_REGISTRY_H
+#define SEND_REGISTRY_H
+
+#include <stdint.h>
+
+/**
+ * Number of fragments staged per device by the scatter-gather send backend
+ * before they are flushed in one ``sendmmsg(2)`` call (one ACK-on-error
+ * window of up to 63 fragments plus its trailing fragment).
+ */
+#define SCHC_SEND_MMSG_BATCH    64U
+
+/**
+ * A C-level send callback.
+ *
+ * :param ctx: The context pointer the callback was registered with.
+ * :param data: The outgoing fragment.
+ * :param length: The length of ``data`` in bytes.
+ * :return: The number of bytes sent (truncated to ``uint8_t``).
+ * :retval 0: on error.
+ */
+typedef uint8_t (*schc_send_fn_t)(void *ctx, uint8_t *data, uint16_t length);
+
+/**
+ * Registers a C-level send callback for a device.
+ *
+ * Fragments for ``device_id`` are then dispatched to ``send`` by
+ * :c:func:`schc_send_dispatch()` without entering Python. Registration,
+ * removal, and dispatch serialize on an internal lock, so they may be called
+ * from any thread; the callback itself is invoked unlocked.
+ *
+ * :param device_id: The identifier of the device to send for.
+ * :type device_id: ``uint32_t``
+ * :param send: The callback to send fragments with.
+ * :type send: :c:type:`schc_send_fn_t`
+ * :param ctx: Passed to ``send`` on every call.
+ * :type ctx: ``void *``
+ * :retval 0: on success.
+ * :retval -1: when memory for the registry can not be allocated.
+ * :rtype: ``int``
+ */
+int schc_send_register(uint32_t device_id, schc_send_fn_t send, void *ctx);
+
+/**
+ * Removes the C-level send callback of a device.
+ *
+ * :param device_id: The identifier of the device to remove the callback of.
+ *     No-op when no callback is registered for ``device_id``.
+ * :type device_id: ``uint32_t``
+ */
+void schc_send_unregister(uint32_t device_id);
+
+/**
+ * Registers ``send(2)`` on a connected datagram socket as send callback.
+ *
+ * This is the allocation-free fast path for the common UDP backend: fragments
+ * for ``device_id`` are written to ``sockfd`` directly from
+ * ``schc_fragment()``.
+ *
+ * :param device_id: The identifier of the device to send for.
+ * :type device_id: ``uint32_t``
+ * :param sockfd: A connected datagram socket file descriptor.
+ * :type sockfd: ``int``
+ * :retval 0: on success.
+ * :retval -1: when memory for the registry can not be allocated.
+ * :rtype: ``int``
+ */
+int schc_send_register_udp(uint32_t device_id, int sockfd);
+
+/**
+ * Registers a batched scatter-gather send backend on a connected datagram
+ * socket.
+ *
+ * Fragments for ``device_id`` are staged into a batch of up to
+ * :c:macro:`SCHC_SEND_MMSG_BATCH` buffers and reach ``sockfd`` with one
+ * ``sendmmsg(2)`` call per batch (a ``send(2)`` loop on platforms without
+ * ``sendmmsg(2)``) — when the batch is full or on
+ * :c:func:`schc_send_flush()` — instead of one syscall per fragment. Since
+ * fragments are held back until then, this backend suits unpaced NO_ACK
+ * transfers rather than duty-cycled or ACK'd ones.
+ *
+ * :param device_id: The identifier of the device to send for.
+ * :type device_id: ``uint32_t``
+ * :param sockfd: A connected datagram socket file descriptor.
+ * :type sockfd: ``int``
+ * :retval 0: on success.
+ * :retval -1: when memory for the backend can not be allocated.
+ * :rtype: ``int``
+ */
+int schc_send_register_mmsg(uint32_t device_id, int sockfd);
+
+/**
+ * Sends out any fragments staged by the scatter-gather send backend of a
+ * device.
+ *
+ * No-op when no backend registered with :c:func:`schc_send_register_mmsg()`
+ * exists for ``device_id``.
+ *
+ * :param device_id: The identifier of the device to flush.
+ * :type device_id: ``uint32_t``
+ * :return: the number of fragments flushed.
+ * :retval -1: when sending failed.
+ * :rtype: ``int``
+ */
+int schc_send_flush(uint32_t device_id);
+
+/**
+ * Checks whether a C-level send callback is registered for a device.
+ *
+ * :param device_id: The identifier of the device to check.
+ * :type device_id: ``uint32_t``
+ * :retval 1: when a callback is registered for ``device_id``.
+ * :retval 0: otherwise.
+ * :rtype: ``int``
+ */
+int schc_send_is_registered(uint32_t device_id);
+
+/**
+ * Sends ``data`` for a device. Matches the ``send`` member of
+ * ``schc_fragmentation_t``.
+ *
+ * Dispatches to the callback registered with :c:func:`schc_send_register()`,
+ * falling back to the Python-callable path (:c:func:`pysend_call()`) when no
+ * C-level callback is registered for ``device_id``.
+ *
+ * :param data: The outgoing fragment.
+ * :type data: ``uint8_t *``
+ * :param length: The length of ``data`` in bytes.
+ * :type length: ``uint16_t``
+ * :param device_id: The identifier of the device to send for.
+ * :type device_id: ``uint32_t``
+ * :return: The number of bytes sent (truncated to ``uint8_t``).
+ * :retval 0: on error.
+ * :rtype: ``uint8_t``
+ */
+uint8_t schc_send_dispatch(uint8_t *data, uint16_t length, uint32_t device_id);
+
+#endif /* !SEND_REGISTRY_H */
@@ -27,6 +27,58 @@ def test_bit_array():
     assert bit_array.bit_length == len(test) * 8
 
 
+def test_bit_array_reuse():
+    # pylint: disable=no-member
+    test = b"Lorem ipsum"
+    bit_array = pylibschc.libschc.BitArray(len(test))
+    assert bit_array.capacity == len(test)
+    bit_array.buffer = test
+    bit_array.clear()
+    # clear() keeps the allocation
+    assert bit_array.capacity == len(test)
+    assert bit_array.length == 0
+    assert bit_array.bit_length == 0
+    assert bit_array.buffer == b""
+    bit_array.load(test)
+    assert bit_array.buffer == test
+    assert bit_array.bit_length == len(test) * 8
+    with pytest.raises(ValueError):
+        bit_array.load(test + b" dolor sit amet")
+    bit_array.reserve(2 * len(test))
+    assert bit_array.capacity >= 2 * len(test)
+    # reserving must not change the content
+    assert bit_array.buffer == test
+    bit_array.load(test + b" dolor")
+    assert bit_array.buffer == test + b" dolor"
+    with pytest.raises(ValueError):
+        bit_array.reserve(-1)
+    # growing via buffer assignment is still possible
+    bit_array.buffer = bytes(4 * len(test))
+    assert bit_array.capacity >= 4 * len(test)
+
+
+def test_bit_array_borrow():
+    # pylint: disable=no-member
+    test = b"Lorem ipsum"
+    bit_array = pylibschc.libschc.BitArray.borrow(memoryview(test))
+    assert bit_array.buffer == test
+    assert bit_array.capacity == len(test)
+    assert bit_array.length == len(test)
+    assert bit_array.bit_length == len(test) * 8
+    assert bit_array.get_bits(0, 8) == test[0]
+    # a borrowed BitArray is read-only
+    with pytest.raises(ValueError):
+        bit_array.buffer = b"foobar"
+    with pytest.raises(ValueError):
+        bit_array.clear()
+    with pytest.raises(ValueError):
+        bit_array.load(b"foobar")
+    with pytest.raises(ValueError):
+        bit_array.reserve(2 * len(test))
+    with pytest.raises(ValueError):
+        bit_array.copy_bits(1, b"\xff", 2)
+
+
 def test_bit_array_get_bits():
     test = b"\x92\xd1"
     bit_array = pylibschc.libschc.BitArray(len(test))  # pylint: disable=no-member
@@ -58,3 +110,19 @@ def test_bit_array_copy_bits():
         bit_array.copy_bits(-1, b"\xf0", 8)
     with pytest.raises(ValueError):
         bit_array.copy_bits(2, b"\xf0", -8)
+
+
+def test_bit_array_copy_bits_unaligned():
+    # pylint: disable=no-member
+    # exercise both the byte-aligned and the unaligned copy kernel
+    test = bytes(range(16))
+    bit_array = pylibschc.libschc.BitArray(len(test))
+    bit_array.buffer = test
+    bit_array.copy_bits(0, b"\xde\xad\xbe\xef", 32)
+    assert bit_array.buffer[:4] == b"\xde\xad\xbe\xef"
+    bit_array.copy_bits(35, b"\xff" * 8, 61)
+    assert bit_array.get_bits(35, 29) == 0x1FFFFFFF
+    assert bit_array.get_bits(64, 32) == 0xFFFFFFFF
+    # bits around the copied run stay untouched
+    assert bit_array.get_bits(32, 3) == test[4] >> 5
+    assert bit_array.get_bits(96, 32) == int.from_bytes(test[12:16], "big")
@@ -6,6 +6,8 @@
 # pylint: disable=missing-class-docstring
 # pylint: disable=missing-function-docstring
 
+import concurrent.futures
+
 import pytest
 from scapy.all import (  # pylint: disable=no-name-in-module
     ICMPv6EchoRequest,
@@ -16,6 +18,7 @@ from scapy.all import (  # pylint: disable=no-name-in-module
 from scapy.contrib.coap import CoAP
 
 import pylibschc.compressor
+import pylibschc.context
 
 __author__ = "Martine S. Lenders"
 __copyright__ = "Copyright 2023 Freie Universität Berlin"
@@ -25,9 +28,8 @@ __email__ = "m.lenders@fu-berlin.de"
 
 @pytest.fixture(autouse=True)
 def reset_compressor_reassembler():
-    del pylibschc.compressor.CompressorDecompressor._inner
     # pylint: disable=protected-access
-    pylibschc.compressor.CompressorDecompressor._inner = None
+    pylibschc.context.EngineContext.current()._compressor_inner = None
 
 
 def test_compressor_reassembler_no_uncompressed_rule(test_rules):
@@ -85,6 +87,126 @@ def test_compressor_reassembler_io_type_error(test_rules):
         c_r.input(12356, pylibschc.compressor.Direction.UP)
 
 
+def test_compressor_reassembler_output_buffer_protocol(test_rules):
+    config = test_rules.deploy()
+    device = config.devices[0]
+    direction = pylibschc.compressor.Direction.UP
+    c_r = pylibschc.compressor.CompressorDecompressor(device=device)
+    pkt = bytes(IPv6())
+    exp_res = c_r.output(pkt, direction)
+    # buffer protocol input has same effect as bytes
+    assert c_r.output(memoryview(pkt), direction) == exp_res
+    assert c_r.output(bytearray(pkt), direction) == exp_res
+
+
+def test_compressor_reassembler_threaded(test_rules):
+    config = test_rules.deploy()
+    device = config.devices[0]
+    direction = pylibschc.compressor.Direction.UP
+    c_r = pylibschc.compressor.CompressorDecompressor(device=device)
+    pkt = bytes(IPv6())
+    exp_res = c_r.output(pkt, direction)
+    with concurrent.futures.ThreadPoolExecutor(max_workers=4) as executor:
+        futures = [
+            executor.submit(c_r.output, pkt, direction) for _ in range(16)
+        ]
+        for future in concurrent.futures.as_completed(futures):
+            assert future.result() == exp_res
+
+
+def test_compressor_reassembler_threaded_rule_swap(test_rules):
+    config = test_rules.deploy()
+    device = config.devices[0]
+    direction = pylibschc.compressor.Direction.UP
+    c_r = pylibschc.compressor.CompressorDecompressor(device=device)
+    pkt = bytes(IPv6())
+    exp_res = c_r.output(pkt, direction)
+    rules = device.compression_rules
+    with concurrent.futures.ThreadPoolExecutor(max_workers=4) as executor:
+        futures = [
+            executor.submit(c_r.output, pkt, direction) for _ in range(16)
+        ]
+        # re-applying the rules swaps in a newly built compression context while
+        # compressions are in flight
+        for _ in range(4):
+            device.compression_rules = rules
+        for future in concurrent.futures.as_completed(futures):
+            assert future.result() == exp_res
+    assert c_r.output(pkt, direction) == exp_res
+
+
+def test_compressor_reassembler_output_batch(test_rules):
+    config = test_rules.deploy()
+    device = config.devices[0]
+    direction = pylibschc.compressor.Direction.UP
+    c_r = pylibschc.compressor.CompressorDecompressor(device=device)
+    pkts = [bytes(IPv6()), bytes(IPv6(hlim=42)), bytes(IPv6(hlim=64))]
+    assert c_r.output_batch([], direction) == []
+    res = c_r.output_batch(pkts, direction)
+    assert len(res) == len(pkts)
+    # batch compression has same effect as packet-wise compression
+    for pkt, batch_res in zip(pkts, res):
+        assert c_r.output(pkt, direction) == batch_res
+    with pytest.raises(ValueError):
+        c_r.output_batch(pkts, pylibschc.compressor.Direction.BI)
+    with pytest.raises(TypeError):
+        c_r.output_batch([12356], direction)
+
+
+def test_compressor_reassembler_input_into(test_rules):
+    config = test_rules.deploy()
+    device = config.devices[0]
+    direction = pylibschc.compressor.Direction.UP
+    c_r = pylibschc.compressor.CompressorDecompressor(device=device)
+    pkt = bytes(IPv6())
+    _, compressed = c_r.output(pkt, direction)
+    out = bytearray(pylibschc.compressor.MAX_MTU_LENGTH)
+    length = c_r.input_into(compressed, direction, out)
+    assert bytes(out[:length]) == pkt
+    # re-using the output buffer yields the same result
+    assert c_r.input_into(compressed, direction, memoryview(out)) == length
+    with pytest.raises(ValueError):
+        c_r.input_into(compressed, direction, bytearray(1))
+
+
+def test_compressor_reassembler_promote_matched_rules(test_rules):
+    config = test_rules.deploy()
+    device = config.devices[0]
+    direction = pylibschc.compressor.Direction.UP
+    c_r = pylibschc.compressor.CompressorDecompressor(device=device)
+    # matches the 3rd compression rule of the device
+    pkt = bytes(
+        IPv6(hlim=64, src="fe80::1", dst="fe80::2")
+        / ICMPv6EchoRequest(id=57428, seq=32838, data="Hello World!")
+    )
+    assert not device.promote_matched_rules
+    exp_res = c_r.output(pkt, direction)
+    device.promote_matched_rules = True
+    assert device.promote_matched_rules
+    # promotion does not change the compression result ...
+    assert c_r.output(pkt, direction) == exp_res
+    # ... but moves the matched rule to the front of the compression context
+    rule_id = exp_res[1].get_bits(0, 8)
+    assert device.__inner__.compression_rules[0]["rule_id"] == rule_id
+    assert c_r.output(pkt, direction) == exp_res
+    assert c_r.output_batch([pkt], direction) == [exp_res]
+
+
+def test_compressor_reassembler_output_reused_bit_arr(test_rules):
+    config = test_rules.deploy()
+    device = config.devices[0]
+    direction = pylibschc.compressor.Direction.UP
+    c_r = pylibschc.compressor.CompressorDecompressor(device=device)
+    pkt = bytes(IPv6())
+    out = pylibschc.compressor.BitArray(len(pkt) + 1)
+    res, bit_arr = c_r.output(pkt, direction, bit_arr=out)
+    assert bit_arr is out
+    # re-using the output buffer yields the same result
+    assert c_r.output(pkt, direction, bit_arr=out) == (res, bit_arr)
+    with pytest.raises(ValueError):
+        c_r.output(pkt, direction, bit_arr=pylibschc.compressor.BitArray(1))
+
+
 @pytest.mark.parametrize(
     "pkt, direction, exp_rules, exp_payload",
     [
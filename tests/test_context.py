@@ -0,0 +1,33 @@
+# Copyright (C) 2023 Freie Universität Berlin
+#
+# SPDX-License-Identifier: GPL-3.0-only
+
+# pylint: disable=missing-module-docstring
+# pylint: disable=missing-function-docstring
+
+import pylibschc.compressor
+import pylibschc.context
+import pylibschc.device
+
+__author__ = "Martine S. Lenders"
+__copyright__ = "Copyright 2023 Freie Universität Berlin"
+__license__ = "GPLv3"
+__email__ = "m.lenders@fu-berlin.de"
+
+
+def test_engine_context_owns_devices():
+    ctx = pylibschc.context.EngineContext.current()
+    assert ctx is pylibschc.context.EngineContext.current()
+    device = pylibschc.device.Device(device_id=1, mtu=60, duty_cycle_ms=500)
+    assert ctx.devices[1] is device
+    assert pylibschc.device.Device.get(1) is device
+    pylibschc.device.Device.delete(1)
+    assert 1 not in ctx.devices
+
+
+def test_engine_context_owns_compressor(test_rules):
+    config = test_rules.deploy()
+    comp_dec1 = pylibschc.compressor.CompressorDecompressor(device=config.devices[0])
+    comp_dec2 = pylibschc.compressor.CompressorDecompressor(device=config.devices[1])
+    # pylint: disable=protected-access
+    assert comp_dec1._inner is comp_dec2._inner
@@ -8,6 +8,7 @@
 
 import logging
 import math
+import threading
 
 import pylibschc.libschc  # pylint: disable=import-error,no-name-in-module
 
@@ -88,3 +89,28 @@ def test_pylog_debug_buffer_overflow(caplog):
         )
         + f"{numbers:04x}"
     )
+
+
+def test_pylog_debug_per_thread_lines(caplog):
+    # pylint: disable=no-member
+    def log_line(name):
+        # line is assembled over two calls; with per-thread line buffers the
+        # other thread's partial line must not be concatenated into it
+        pylibschc.libschc.test_pylog_debug(b"partial %s for %d", name, 1)
+        pylibschc.libschc.test_pylog_debug(b" done %s after %d\n", name, 2)
+
+    with caplog.at_level(logging.DEBUG):
+        thread = threading.Thread(target=log_line, args=(b"thread",))
+        pylibschc.libschc.test_pylog_debug(b"partial %s for %d", b"main", 1)
+        thread.start()
+        thread.join()
+        pylibschc.libschc.test_pylog_debug(b" done %s after %d\n", b"main", 2)
+    assert "partial thread for 1 done thread after 2" in caplog.text
+    assert "partial main for 1 done main after 2" in caplog.text
+
+
+def test_pylog_flush():
+    # pylint: disable=no-member
+    # all records of a GIL-holding thread are forwarded synchronously, so
+    # nothing is left to flush here
+    assert pylibschc.libschc.pylog_flush() == 0
@@ -54,6 +54,23 @@ def test_device_iter():
         assert device == iter_device
 
 
+def test_device_many():
+    # exercise resizing of the libSCHC-internal device index
+    devices = {}
+    for i in range(1, 101):
+        devices[i] = pylibschc.device.Device(i, 50, 5000)
+    for i in range(1, 101):
+        assert pylibschc.device.Device.get(i) == devices[i]
+    with pytest.raises(ValueError):
+        pylibschc.device.Device(0, 50, 5000)
+    for i in range(1, 101, 2):
+        pylibschc.device.Device.delete(i)
+        with pytest.raises(KeyError):
+            pylibschc.device.Device.get(i)
+    for i in range(2, 101, 2):
+        assert pylibschc.device.Device.get(i) == devices[i]
+
+
 def test_device_compression_rules():
     device = pylibschc.device.Device(1, 50, 5000)
     compression_rules = [
@@ -104,6 +121,98 @@ def test_device_compression_rules():
     assert not device.compression_rules
 
 
+def test_device_rules_binary():
+    device = pylibschc.device.Device(1, 50, 5000)
+    compression_rules = [
+        pylibschc.rules.CompressionRule(
+            rule_id=1,
+            rule_id_size_bits=8,
+            ipv6_rule=[
+                pylibschc.rules.CompressionRuleField(
+                    field="IP6_TC",
+                    MO_param_length=0,
+                    field_length=8,
+                    field_pos=1,
+                    dir="BI",
+                    MO="ignore",
+                    action="NotSent",
+                ),
+                pylibschc.rules.CompressionRuleField(
+                    field="IP6_NH",
+                    MO_param_length=2,
+                    field_length=8,
+                    field_pos=1,
+                    dir="BI",
+                    target_value=[17, 58],
+                    MO="matchmap",
+                    action="mappingSent",
+                ),
+            ],
+            udp_rule=[
+                pylibschc.rules.CompressionRuleField(
+                    field="UDP_LEN",
+                    MO_param_length=0,
+                    field_length=16,
+                    field_pos=1,
+                    dir="BI",
+                    MO="ignore",
+                    action="COMPLENGTH",
+                ),
+            ],
+        )
+    ]
+    device.compression_rules = compression_rules
+    dump = device.dump_rules_binary()
+    device.compression_rules = None
+    assert not device.compression_rules
+    device.load_rules_binary(dump)
+    assert device.compression_rules == compression_rules
+    assert device.dump_rules_binary() == dump
+    # empty context
+    device.load_rules_binary(b"\0")
+    assert not device.compression_rules
+    with pytest.raises(ValueError):
+        device.load_rules_binary(b"")
+    with pytest.raises(ValueError):
+        device.load_rules_binary(dump[:-1])
+    with pytest.raises(ValueError):
+        device.load_rules_binary(dump + b"\0")
+    # action byte of the first field (context header: count:u8 + rule:u32+u8+u8,
+    # layer length:u8, action at field offset 7) out of CDA range
+    corrupt = bytearray(dump)
+    corrupt[15] = 0xFF
+    with pytest.raises(ValueError):
+        device.load_rules_binary(bytes(corrupt))
+
+
+def test_device_rules_file(tmp_path):
+    device = pylibschc.device.Device(1, 50, 5000)
+    device.compression_rules = [
+        pylibschc.rules.CompressionRule(
+            rule_id=1,
+            rule_id_size_bits=8,
+            ipv6_rule=[
+                pylibschc.rules.CompressionRuleField(
+                    field="IP6_HL",
+                    MO_param_length=0,
+                    field_length=8,
+                    field_pos=1,
+                    dir="BI",
+                    target_value=64,
+                    MO="EQUAL",
+                    action="NOTSENT",
+                ),
+            ],
+        )
+    ]
+    compression_rules = device.compression_rules
+    rules_file = tmp_path / "rules.bin"
+    device.dump_rules_file(rules_file)
+    device.compression_rules = None
+    device.load_rules_file(rules_file)
+    assert device.compression_rules == compression_rules
+
+
 def test_device_device_id():
     device = pylibschc.device.Device(60182, 50, 5000)
     assert device.device_id == 60182
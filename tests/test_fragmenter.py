@@ -7,8 +7,11 @@
 # pylint: disable=missing-function-docstring
 
 import asyncio
+import mmap
 import queue
+import socket
 import threading
+import time
 import typing
 
 import pytest
@@ -186,6 +189,266 @@ TEST_PARAMS = [
 ]
 
 
+def test_fragmenter_reassembler_input_batch(test_rules):
+    received = []
+    config = test_rules.deploy()
+    device = config.devices[1]
+    reassembler = pylibschc.fragmenter.FragmenterReassembler(
+        device=device,
+        end_rx=lambda conn: received.append(conn.mbuf),
+    )
+    reassembler.register_send(len)
+    try:
+        assert reassembler.input_batch([]) == []
+        pkts = [b"foobar", b"snafu", b"foobar"]
+        assert reassembler.input_batch(pkts) == (
+            [pylibschc.fragmenter.ReassemblyStatus.COMPLETED] * len(pkts)
+        )
+        assert received == pkts
+    finally:
+        reassembler.unregister_send()
+
+
+def test_fragmenter_reassembler_input_batch_fragments(test_rules):
+    fragments = []
+    received = []
+    config = test_rules.deploy()
+    device_f = config.devices[0]
+    device_r = config.devices[1]
+    fragmenter = pylibschc.fragmenter.FragmenterReassembler(
+        device=device_f,
+        mode=pylibschc.fragmenter.FragmentationMode.NO_ACK,
+    )
+    reassembler = pylibschc.fragmenter.FragmenterReassembler(
+        device=device_r,
+        end_rx=lambda conn: received.append(conn.mbuf),
+    )
+
+    def send(buffer):
+        fragments.append(buffer)
+        return len(buffer)
+
+    fragmenter.register_send(send)
+    reassembler.register_send(len)
+    try:
+        data = (
+            b"Lorem ipsum dolor sit amet, consetetur sadipscing elitr, sed diam"
+        )
+        assert (
+            fragmenter.output_paced(data)
+            == pylibschc.fragmenter.FragmentationResult.SUCCESS
+        )
+        assert len(fragments) > 1
+        # the whole burst is reassembled in one call, e.g. as drained by one
+        # recvmmsg() call
+        statuses = reassembler.input_batch(fragments)
+        assert statuses == (
+            [pylibschc.fragmenter.ReassemblyStatus.ONGOING] * (len(fragments) - 1)
+            + [pylibschc.fragmenter.ReassemblyStatus.COMPLETED]
+        )
+        assert received == [data]
+    finally:
+        fragmenter.unregister_send()
+        reassembler.unregister_send()
+
+
+def test_fragmenter_reassembler_output_bad_input_releases_lock(test_rules):
+    config = test_rules.deploy()
+    fragmenter = pylibschc.fragmenter.FragmenterReassembler(
+        device=config.devices[0],
+        mode=pylibschc.fragmenter.FragmentationMode.NO_ACK,
+    )
+    fragmenter.register_send(len)
+    try:
+        with pytest.raises(TypeError):
+            fragmenter.output_paced("not bytes")
+        # the TX lock was released again, so further transmissions go through
+        assert (
+            fragmenter.output_paced(b"foobar")
+            == pylibschc.fragmenter.FragmentationResult.NO_FRAGMENTATION
+        )
+    finally:
+        fragmenter.unregister_send()
+
+
+def test_fragmenter_reassembler_send_socket(test_rules):
+    received = []
+    config = test_rules.deploy()
+    device_f = config.devices[0]
+    device_r = config.devices[1]
+    fragmenter = pylibschc.fragmenter.FragmenterReassembler(
+        device=device_f,
+        mode=pylibschc.fragmenter.FragmentationMode.NO_ACK,
+    )
+    reassembler = pylibschc.fragmenter.FragmenterReassembler(
+        device=device_r,
+        end_rx=lambda conn: received.append(conn.mbuf),
+    )
+    tx_sock, rx_sock = socket.socketpair(socket.AF_UNIX, socket.SOCK_DGRAM)
+    fragmenter.register_send_socket(tx_sock)
+    reassembler.register_send(len)
+    try:
+        data = (
+            b"Lorem ipsum dolor sit amet, consetetur sadipscing elitr, sed diam"
+        )
+        assert (
+            fragmenter.output_paced(data)
+            == pylibschc.fragmenter.FragmentationResult.SUCCESS
+        )
+        # feed the fragments sent via the socket fast path to the reassembler
+        rx_sock.setblocking(False)
+        while not received:
+            reassembler.input(rx_sock.recv(MTU))
+        assert received == [data]
+    finally:
+        fragmenter.unregister_send_socket()
+        reassembler.unregister_send()
+        tx_sock.close()
+        rx_sock.close()
+
+
+def test_fragmenter_reassembler_send_mmsg(test_rules):
+    received = []
+    config = test_rules.deploy()
+    device_f = config.devices[0]
+    device_r = config.devices[1]
+    fragmenter = pylibschc.fragmenter.FragmenterReassembler(
+        device=device_f,
+        mode=pylibschc.fragmenter.FragmentationMode.NO_ACK,
+    )
+    reassembler = pylibschc.fragmenter.FragmenterReassembler(
+        device=device_r,
+        end_rx=lambda conn: received.append(conn.mbuf),
+    )
+    tx_sock, rx_sock = socket.socketpair(socket.AF_UNIX, socket.SOCK_DGRAM)
+    fragmenter.register_send_mmsg(tx_sock)
+    reassembler.register_send(len)
+    try:
+        data = (
+            b"Lorem ipsum dolor sit amet, consetetur sadipscing elitr, sed diam"
+        )
+        assert (
+            fragmenter.output_paced(data)
+            == pylibschc.fragmenter.FragmentationResult.SUCCESS
+        )
+        # the whole transfer was staged in C and flushed on end of TX, so the
+        # fragments arrive as one sendmmsg() batch
+        assert fragmenter.flush_send() == 0
+        rx_sock.setblocking(False)
+        while not received:
+            reassembler.input(rx_sock.recv(MTU))
+        assert received == [data]
+    finally:
+        fragmenter.unregister_send_socket()
+        reassembler.unregister_send()
+        tx_sock.close()
+        rx_sock.close()
+
+
+def test_fragmenter_reassembler_output_mmap(test_rules, tmp_path):
+    received = []
+    config = test_rules.deploy()
+    device_f = config.devices[0]
+    device_r = config.devices[1]
+    fragmenter = pylibschc.fragmenter.FragmenterReassembler(
+        device=device_f,
+        mode=pylibschc.fragmenter.FragmentationMode.NO_ACK,
+    )
+    reassembler = pylibschc.fragmenter.FragmenterReassembler(
+        device=device_r,
+        end_rx=lambda conn: received.append(conn.mbuf),
+    )
+
+    def send(buffer):
+        reassembler.input(buffer)
+        return len(buffer)
+
+    fragmenter.register_send(send)
+    reassembler.register_send(len)
+    data = b"Lorem ipsum dolor sit amet, consetetur sadipscing elitr, sed diam"
+    payload_file = tmp_path / "payload.bin"
+    payload_file.write_bytes(data)
+    try:
+        # the payload is fragmented straight from the page cache, without being
+        # copied into a per-connection buffer
+        with payload_file.open("rb") as payload:
+            with mmap.mmap(
+                payload.fileno(), 0, access=mmap.ACCESS_READ
+            ) as mapped_payload:
+                assert (
+                    fragmenter.output_paced(mapped_payload)
+                    == pylibschc.fragmenter.FragmentationResult.SUCCESS
+                )
+        assert received == [data]
+    finally:
+        fragmenter.unregister_send()
+        reassembler.unregister_send()
+
+
+def test_fragmenter_reassembler_send_packet(test_rules):
+    received = []
+    end_tx = threading.Event()
+    config = test_rules.deploy()
+    device_f = config.devices[0]
+    device_r = config.devices[1]
+    c_r = pylibschc.compressor.CompressorDecompressor(device_f)
+    fragmenter = pylibschc.fragmenter.FragmenterReassembler(
+        device=device_f,
+        mode=pylibschc.fragmenter.FragmentationMode.NO_ACK,
+        end_tx=lambda conn: end_tx.set(),
+    )
+    reassembler = pylibschc.fragmenter.FragmenterReassembler(
+        device=device_r,
+        end_rx=lambda conn: received.append(conn.mbuf),
+    )
+
+    def send(buffer):
+        reassembler.input(buffer)
+        return len(buffer)
+
+    fragmenter.register_send(send)
+    reassembler.register_send(len)
+    try:
+        with pytest.raises(ValueError):
+            fragmenter.send_packet(b"foobar", pylibschc.rules.Direction.BI)
+        data = bytes(
+            IPv6(hlim=64, src="2001:db8:1::2", dst="2001:db8::1")
+            / UDP(
+                sport=8001,
+                dport=8000,
+            )
+            / CoAP(
+                ver=1,
+                code="GET",
+                type="NON",
+                msg_id=0x23B0,
+                token=b"\x12\x34\x56\x78",
+                options=[("Uri-Path", b"temp")],
+                paymark=b"\xff",
+            )
+            / b"Lorem ipsum dolor sit amet, consetetur sadipscing elitr, sed diam"
+        )
+        assert fragmenter.send_packet(data, pylibschc.rules.Direction.DOWN) == (
+            pylibschc.compressor.CompressionResult.COMPRESSED,
+            pylibschc.fragmenter.FragmentationResult.SUCCESS,
+        )
+        assert end_tx.wait(10 * DUTY_CYCLE_MS / 1000)
+        assert len(received) == 1
+        assert c_r.input(received[0], pylibschc.rules.Direction.DOWN) == data
+        end_tx.clear()
+        received.clear()
+        # small packets fall back to the uncompressed rule and are sent unfragmented
+        assert fragmenter.send_packet(b"foobar", pylibschc.rules.Direction.DOWN) == (
+            pylibschc.compressor.CompressionResult.UNCOMPRESSED,
+            pylibschc.fragmenter.FragmentationResult.NO_FRAGMENTATION,
+        )
+        assert len(received) == 1
+        assert c_r.input(received[0], pylibschc.rules.Direction.DOWN) == b"foobar"
+    finally:
+        fragmenter.unregister_send()
+        reassembler.unregister_send()
+
+
 class TestFragmenterReassemblerThreaded:  # pylint: disable=too-many-instance-attributes
     # pylint: disable=attribute-defined-outside-init
     def setup_method(self, method):  # pylint: disable=unused-argument
@@ -341,6 +604,190 @@ class TestFragmenterReassemblerThreaded:  # pylint: disable=too-many-instance-at
         self.fragmenter.unregister_send()
 
 
+def test_timer_wheel_full_revolution_delay():
+    event = threading.Event()
+    wheel = pylibschc.fragmenter.TimerWheel(tick=0.05, slots=4)
+    # a delay of exactly one wheel revolution lands on the current slot and
+    # must fire on its first visit, not one revolution late
+    start = time.monotonic()
+    wheel.post_timer_task(object(), lambda arg: event.set(), 0.2, None)
+    assert event.wait(timeout=1.0)
+    assert time.monotonic() - start < 0.3
+
+
+class TestFragmenterReassemblerTimerWheel:
+    # pylint: disable=attribute-defined-outside-init
+    # exercises the default timer wheel, i.e., no explicit
+    # post_timer_task/remove_timer_entry callbacks are provided
+    def setup_method(self, method):  # pylint: disable=unused-argument
+        self.reassembler_queue = queue.Queue()
+        self.end_tx_event = threading.Event()
+        self.c_r = None
+        self.exp_data = None
+
+    def send_frag(self, buffer: bytes) -> int:
+        assert len(buffer) <= MTU
+        self.reassembler.input(self.input_type(buffer))
+        return len(buffer)
+
+    def send_ack(self, buffer: bytes) -> int:
+        assert len(buffer) <= MTU
+        self.fragmenter.input(self.input_type(buffer))
+        return len(buffer)
+
+    def end_rx(self, conn: pylibschc.fragmenter.FragmentationConnection):
+        mbuf = conn.mbuf
+        # copying into a caller-provided buffer yields the same packet
+        out = bytearray(len(mbuf))
+        assert conn.mbuf_copy_into(out) == len(mbuf)
+        assert bytes(out) == mbuf
+        with pytest.raises(ValueError):
+            conn.mbuf_copy_into(bytearray(len(mbuf) - 1))
+        if self.exp_data is not None:
+            # fused reassembly + decompression yields the original packet
+            assert (
+                self.c_r.input_mbuf(conn, pylibschc.rules.Direction.DOWN)
+                == self.exp_data
+            )
+        self.reassembler_queue.put_nowait(mbuf)
+
+    def end_tx(self, conn: pylibschc.fragmenter.FragmentationConnection):
+        assert self.fragmenter.device.device_id == conn.device_id
+        self.end_tx_event.set()
+
+    @pytest.mark.parametrize(
+        "mode, input_type, data, compress_data, exp_result", TEST_PARAMS
+    )
+    def test_fragmenter_reassembler_timer_wheel(  # pylint: disable=too-many-arguments
+        self, test_rules, mode, input_type, data, compress_data, exp_result, subtests
+    ):
+        config = test_rules.deploy()
+        device_f = config.devices[0]
+        device_r = config.devices[1]
+        self.input_type = input_type
+        c_r = pylibschc.compressor.CompressorDecompressor(device_f)
+        if compress_data:
+            self.c_r = c_r
+            self.exp_data = data
+        self.fragmenter = pylibschc.fragmenter.FragmenterReassembler(
+            device=device_f,
+            mode=mode,
+            end_tx=self.end_tx,
+        )
+        self.reassembler = pylibschc.fragmenter.FragmenterReassembler(
+            device=device_r,
+            end_rx=self.end_rx,
+        )
+        self.fragmenter.register_send(self.send_frag)
+        self.reassembler.register_send(self.send_ack)
+        for i in range(REPEATS):  # check for idempotency
+            with subtests.test("loop", i=i):
+                self.end_tx_event.clear()
+                if compress_data:
+                    res, pkt = c_r.output(
+                        self.input_type(data), pylibschc.rules.Direction.DOWN
+                    )
+                    assert res == pylibschc.compressor.CompressionResult.COMPRESSED
+                    assert self.fragmenter.output(pkt) == exp_result
+                else:
+                    assert self.fragmenter.output(self.input_type(data)) == exp_result
+                assert self.end_tx_event.wait(timeout=(DUTY_CYCLE_MS / 1000) * 10)
+                pkt = self.reassembler_queue.get(timeout=(DUTY_CYCLE_MS / 1000) * 10)
+                if compress_data:
+                    assert c_r.input(pkt, pylibschc.rules.Direction.DOWN) == data
+                else:
+                    assert pkt == data
+        self.fragmenter.unregister_send()
+        self.reassembler.unregister_send()
+
+    @pytest.mark.parametrize(
+        "mode, input_type, data, compress_data, exp_result", TEST_PARAMS
+    )
+    def test_fragmenter_reassembler_output_paced(  # pylint: disable=too-many-arguments
+        self, test_rules, mode, input_type, data, compress_data, exp_result
+    ):
+        config = test_rules.deploy()
+        device_f = config.devices[0]
+        device_r = config.devices[1]
+        self.input_type = input_type
+        c_r = pylibschc.compressor.CompressorDecompressor(device_f)
+        if compress_data:
+            self.c_r = c_r
+            self.exp_data = data
+        self.fragmenter = pylibschc.fragmenter.FragmenterReassembler(
+            device=device_f,
+            mode=mode,
+            end_tx=self.end_tx,
+        )
+        self.reassembler = pylibschc.fragmenter.FragmenterReassembler(
+            device=device_r,
+            end_rx=self.end_rx,
+        )
+        self.fragmenter.register_send(self.send_frag)
+        self.reassembler.register_send(self.send_ack)
+        try:
+            if compress_data:
+                res, pkt = c_r.output(
+                    self.input_type(data), pylibschc.rules.Direction.DOWN
+                )
+                assert res == pylibschc.compressor.CompressionResult.COMPRESSED
+                assert self.fragmenter.output_paced(pkt) == exp_result
+            else:
+                assert (
+                    self.fragmenter.output_paced(self.input_type(data)) == exp_result
+                )
+            # paced output only returns after the transmission completed
+            assert self.end_tx_event.is_set()
+            pkt = self.reassembler_queue.get_nowait()
+            if compress_data:
+                assert c_r.input(pkt, pylibschc.rules.Direction.DOWN) == data
+            else:
+                assert pkt == data
+        finally:
+            self.fragmenter.unregister_send()
+            self.reassembler.unregister_send()
+
+
+@pytest.mark.asyncio
+async def test_async_fragmenter_reassembler(test_rules):
+    received = []
+    config = test_rules.deploy()
+    fragmenter = pylibschc.fragmenter.AsyncFragmenterReassembler(
+        device=config.devices[0],
+        mode=pylibschc.fragmenter.FragmentationMode.NO_ACK,
+    )
+    reassembler = pylibschc.fragmenter.AsyncFragmenterReassembler(
+        device=config.devices[1],
+        end_rx=lambda conn: received.append(conn.mbuf),
+    )
+
+    async def send(buffer):
+        reassembler.input(buffer)
+
+    fragmenter.register_send(send)
+    reassembler.register_send(len)
+    try:
+        data = (
+            b"Lorem ipsum dolor sit amet, consetetur sadipscing elitr, sed diam"
+        )
+        # resolves via event-loop timers once the last fragment was sent
+        assert (
+            await fragmenter.output(data)
+            == pylibschc.fragmenter.FragmentationResult.SUCCESS
+        )
+        assert received == [data]
+        assert (
+            await fragmenter.output(b"foobar")
+            == pylibschc.fragmenter.FragmentationResult.NO_FRAGMENTATION
+        )
+        # let the scheduled send coroutine deliver the unfragmented packet
+        await asyncio.sleep(0)
+        assert received == [data, b"foobar"]
+    finally:
+        fragmenter.unregister_send()
+        reassembler.unregister_send()
+
+
 class TestFragmenterReassemblerAsync:  # pylint: disable=too-many-instance-attributes
     # pylint: disable=attribute-defined-outside-init
     def setup_method(self, method):  # pylint: disable=unused-argument
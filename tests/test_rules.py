@@ -1072,6 +1072,33 @@ def test_config_duplicate_device():
         )
 
 
+def test_compiled_config_deploy(test_rules):
+    compiled = test_rules.compile()
+    # compiling unchanged content returns the cached compilation
+    assert test_rules.compile() is compiled
+    assert pylibschc.rules.CompiledConfig.compile(test_rules) is compiled
+    config = compiled.deploy()
+    for device, device_config in zip(config.devices, test_rules.devices):
+        assert device.device_id == device_config.device_id
+        assert device.mtu == device_config.mtu
+        assert device.duty_cycle_ms == device_config.duty_cycle
+        assert device.compression_rules == (device_config.compression_rules or [])
+        assert device.fragmentation_rules == (device_config.fragmentation_rules or [])
+        assert device.uncompressed_rule == device_config.uncompressed_rule
+    # re-deploying the unchanged compiled config leaves the devices untouched
+    assert [d.device_id for d in compiled.deploy().devices] == [
+        d.device_id for d in config.devices
+    ]
+    # a changed config deploys again
+    changed = pylibschc.rules.Config(**test_rules.dict())
+    changed.devices[0].duty_cycle = test_rules.devices[0].duty_cycle + 1
+    recompiled = changed.compile()
+    assert recompiled is not compiled
+    assert recompiled.deploy().devices[0].duty_cycle_ms == (
+        test_rules.devices[0].duty_cycle + 1
+    )
+
+
 @pytest.fixture
 def exp_rules_config(request):
     test_dir = os.path.dirname(request.module.__file__)
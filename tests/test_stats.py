@@ -0,0 +1,31 @@
+# Copyright (C) 2023 Freie Universität Berlin
+#
+# SPDX-License-Identifier: GPL-3.0-only
+
+# pylint: disable=missing-module-docstring
+# pylint: disable=missing-function-docstring
+
+import pylibschc.compressor
+import pylibschc.stats
+import pylibschc.rules
+
+__author__ = "Martine S. Lenders"
+__copyright__ = "Copyright 2023 Freie Universität Berlin"
+__license__ = "GPLv3"
+__email__ = "m.lenders@fu-berlin.de"
+
+
+def test_stats_snapshot(test_rules):
+    config = test_rules.deploy()
+    comp_dec = pylibschc.compressor.CompressorDecompressor(device=config.devices[0])
+    before = pylibschc.stats.snapshot()
+    comp_dec.output(b"foobar", pylibschc.rules.Direction.DOWN)
+    after = pylibschc.stats.snapshot()
+    assert len(pylibschc.stats.Snapshot.bucket_bounds()) == len(after.compress_ns)
+    if pylibschc.stats.enabled():
+        assert after.compress_calls == before.compress_calls + 1
+        # every call lands in exactly one latency bucket
+        assert sum(after.compress_ns) == after.compress_calls
+    else:  # pragma: no cover, only with an NSTATS=1 build
+        assert after.compress_calls == 0
+        assert sum(after.compress_ns) == 0